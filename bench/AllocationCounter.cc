@@ -0,0 +1,139 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// libjwt brings its own operator new when it counts allocations.
+#if !defined(JWT_COUNT_ALLOCATIONS)
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocation_count {0};
+std::atomic<std::uint64_t> g_allocated_bytes {0};
+
+void* counted_allocate(std::size_t size)
+{
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+  {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size)
+{
+  return counted_allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return counted_allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+#endif // !JWT_COUNT_ALLOCATIONS
+
+namespace jwt {
+namespace bench {
+
+AllocationStats AllocationStats::now()
+{
+#if defined(JWT_COUNT_ALLOCATIONS)
+  // Benchmarks run on a single thread, so its counts are the whole story.
+  auto allocations = thread_allocations();
+  return AllocationStats{allocations.count, allocations.bytes};
+#else
+  return AllocationStats{
+    g_allocation_count.load(std::memory_order_relaxed),
+    g_allocated_bytes.load(std::memory_order_relaxed)
+  };
+#endif
+}
+
+void report_allocations(benchmark::State& state, const AllocationStats& start)
+{
+  auto end = AllocationStats::now();
+
+  state.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(end.count - start.count), benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes"] = benchmark::Counter(
+      static_cast<double>(end.bytes - start.bytes), benchmark::Counter::kAvgIterations);
+}
+
+PhaseAllocations::PhaseAllocations()
+{
+  if (kCountsAllocations)
+  {
+    set_stats(&stats_);
+  }
+}
+
+PhaseAllocations::~PhaseAllocations()
+{
+  if (kCountsAllocations)
+  {
+    set_stats(nullptr);
+  }
+}
+
+void PhaseAllocations::report(benchmark::State& state) const
+{
+  for (std::size_t i = 0; i < kNumPhases; ++i)
+  {
+    auto phase = static_cast<Phase>(i);
+    auto allocations = stats_.totals(phase).allocations;
+    if (allocations.count == 0)
+    {
+      continue;
+    }
+
+    state.counters[std::string{phase_name(phase)} + "_allocs"] = benchmark::Counter(
+        static_cast<double>(allocations.count), benchmark::Counter::kAvgIterations);
+  }
+}
+
+} // namespace bench
+} // namespace jwt
@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_BENCH_ALLOCATIONCOUNTER_H
+#define JWT_BENCH_ALLOCATIONCOUNTER_H
+
+#pragma once
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+#include "libjwt/Stats.h"
+
+namespace jwt {
+namespace bench {
+
+// A snapshot of the counts kept by jwt_bench's replacement operator new, or by
+// libjwt's when it is built with JWT_COUNT_ALLOCATIONS.
+struct AllocationStats
+{
+  std::uint64_t count {0};
+  std::uint64_t bytes {0};
+
+  static AllocationStats now();
+};
+
+// Reports allocations made since `start` as per-iteration counters.
+void report_allocations(benchmark::State& state, const AllocationStats& start);
+
+// Breaks a benchmark's allocations down by libjwt phase, e.g. "json_allocs",
+// when libjwt counts allocations; otherwise does nothing.
+class PhaseAllocations
+{
+public:
+  PhaseAllocations();
+  ~PhaseAllocations();
+
+  PhaseAllocations(const PhaseAllocations&) = delete;
+  PhaseAllocations& operator=(const PhaseAllocations&) = delete;
+
+  void report(benchmark::State& state) const;
+
+private:
+  Stats stats_;
+};
+
+} // namespace bench
+} // namespace jwt
+
+#endif // JWT_BENCH_ALLOCATIONCOUNTER_H
@@ -0,0 +1,292 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "libjwt/Decoder.h"
+#include "libjwt/JsonPrinter.h"
+#include "libjwt/JsonVisitor.h"
+#include "libjwt/Jwt.h"
+
+#include "AllocationCounter.h"
+#include "PerfCounters.h"
+#include "Base64.h"
+
+namespace jwt {
+namespace bench {
+
+namespace {
+
+struct Fixture
+{
+  std::string name;
+  std::string token;
+  std::string encoded_payload;
+  std::string payload_json;
+  ordered_json payload;
+};
+
+Fixture make_fixture(std::string name, const ordered_json& header, const ordered_json& payload)
+{
+  Fixture fixture;
+  fixture.name = std::move(name);
+  fixture.payload = payload;
+  fixture.payload_json = payload.dump();
+  fixture.encoded_payload = base64_urlsafe_encode(fixture.payload_json);
+  fixture.token = base64_urlsafe_encode(header.dump())
+      + "." + fixture.encoded_payload
+      + "." + base64_urlsafe_encode(std::string(32, '\x5a'));
+  return fixture;
+}
+
+std::vector<Fixture> make_fixtures()
+{
+  std::vector<Fixture> fixtures;
+
+  fixtures.push_back(make_fixture(
+      "small",
+      ordered_json::parse(R"({"alg":"none"})"),
+      ordered_json::parse(R"({"sub":"1"})")));
+
+  fixtures.push_back(make_fixture(
+      "typical",
+      ordered_json::parse(R"({"alg":"RS256","typ":"JWT","kid":"2c6fa6f5950a7ce465fcf247aa0b094828ac952c"})"),
+      ordered_json::parse(R"({
+        "iss": "https://accounts.example.com",
+        "sub": "110169484474386276334",
+        "aud": ["gateway", "billing"],
+        "exp": 1760000000,
+        "nbf": 1759996400,
+        "iat": 1759996400,
+        "jti": "b9f2c1d4-5e6a-4b7c-8d9e-0f1a2b3c4d5e",
+        "scope": "openid profile email offline_access",
+        "name": "Jane Q. Public",
+        "email": "jane@example.com",
+        "email_verified": true,
+        "roles": ["admin", "auditor"],
+        "tenant": {"id": 42, "region": "eu-west-1", "tier": "enterprise"}
+      })")));
+
+  ordered_json large = ordered_json::object();
+  for (int i = 0; i < 2000; ++i)
+  {
+    auto key = "claim_" + std::to_string(i);
+    switch (i % 5)
+    {
+      case 0:
+        large[key] = "value number " + std::to_string(i) + " ünïcødé ✓";
+        break;
+      case 1:
+        large[key] = i * 1000003;
+        break;
+      case 2:
+        large[key] = i / 7.0;
+        break;
+      case 3:
+        large[key] = {i, i + 1, i + 2, "x", nullptr, false};
+        break;
+      case 4:
+        large[key] = {{"nested", {{"depth", 2}, {"values", {1, 2, 3}}}}, {"flag", true}};
+        break;
+    }
+  }
+  fixtures.push_back(make_fixture("large", ordered_json::parse(R"({"alg":"HS512","typ":"JWT"})"), large));
+
+  return fixtures;
+}
+
+class NullBuffer : public std::streambuf
+{
+protected:
+  virtual int overflow(int c) override
+  {
+    return c;
+  }
+
+  virtual std::streamsize xsputn(const char*, std::streamsize n) override
+  {
+    return n;
+  }
+};
+
+class NullVisitor : public IJsonVisitor
+{
+public:
+  virtual void on_object_start() override { ++events; }
+  virtual void on_object_field_name(const std::string&) override { ++events; }
+  virtual void on_object_end() override { ++events; }
+  virtual void on_array_start() override { ++events; }
+  virtual void on_array_end() override { ++events; }
+  virtual void on_null() override { ++events; }
+  virtual void on_string(const std::string&) override { ++events; }
+  virtual void on_signed_number(std::int64_t) override { ++events; }
+  virtual void on_unsigned_number(std::uint64_t) override { ++events; }
+  virtual void on_floating_point_number(double) override { ++events; }
+  virtual void on_boolean(bool) override { ++events; }
+
+  std::size_t events {0};
+};
+
+void set_throughput(benchmark::State& state, std::size_t bytes_per_token)
+{
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes_per_token));
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+void bm_base64_urlsafe_decode(benchmark::State& state, const Fixture& fixture)
+{
+  auto counters = PerfSample::now();
+  auto allocations = AllocationStats::now();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(base64_urlsafe_decode(fixture.encoded_payload));
+  }
+  report_allocations(state, allocations);
+  report_perf_counters(state, counters);
+  set_throughput(state, fixture.encoded_payload.size());
+}
+
+void bm_jwt_parse(benchmark::State& state, const Fixture& fixture)
+{
+  PhaseAllocations phases;
+  auto counters = PerfSample::now();
+  auto allocations = AllocationStats::now();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(Jwt::parse(fixture.token));
+  }
+  report_allocations(state, allocations);
+  report_perf_counters(state, counters);
+  phases.report(state);
+  set_throughput(state, fixture.token.size());
+}
+
+void bm_decoder_parse_into(benchmark::State& state, const Fixture& fixture)
+{
+  Decoder decoder;
+  Jwt token;
+
+  PhaseAllocations phases;
+  auto counters = PerfSample::now();
+  auto allocations = AllocationStats::now();
+  for (auto _ : state)
+  {
+    decoder.parse_into(fixture.token, token);
+    benchmark::DoNotOptimize(token);
+  }
+  report_allocations(state, allocations);
+  report_perf_counters(state, counters);
+  phases.report(state);
+  set_throughput(state, fixture.token.size());
+}
+
+void bm_visit(benchmark::State& state, const Fixture& fixture)
+{
+  NullVisitor visitor;
+
+  auto counters = PerfSample::now();
+  auto allocations = AllocationStats::now();
+  for (auto _ : state)
+  {
+    visit(fixture.payload, visitor);
+  }
+  report_allocations(state, allocations);
+  report_perf_counters(state, counters);
+  set_throughput(state, fixture.payload_json.size());
+  benchmark::DoNotOptimize(visitor.events);
+}
+
+void bm_pretty_print_json(benchmark::State& state, const Fixture& fixture, bool use_ansi_colors)
+{
+  NullBuffer buffer;
+  std::ostream os{&buffer};
+
+  PhaseAllocations phases;
+  auto counters = PerfSample::now();
+  auto allocations = AllocationStats::now();
+  for (auto _ : state)
+  {
+    pretty_print_json(os, fixture.payload, use_ansi_colors);
+  }
+  report_allocations(state, allocations);
+  report_perf_counters(state, counters);
+  phases.report(state);
+  set_throughput(state, fixture.payload_json.size());
+}
+
+void register_benchmarks(const std::vector<Fixture>& fixtures)
+{
+  for (const auto& fixture : fixtures)
+  {
+    const auto& f = fixture;
+    benchmark::RegisterBenchmark(("base64_urlsafe_decode/" + f.name).c_str(), bm_base64_urlsafe_decode, std::cref(f));
+    benchmark::RegisterBenchmark(("Jwt::parse/" + f.name).c_str(), bm_jwt_parse, std::cref(f));
+    benchmark::RegisterBenchmark(("Decoder::parse_into/" + f.name).c_str(), bm_decoder_parse_into, std::cref(f));
+    benchmark::RegisterBenchmark(("visit/" + f.name).c_str(), bm_visit, std::cref(f));
+    benchmark::RegisterBenchmark(("pretty_print_json/plain/" + f.name).c_str(), bm_pretty_print_json, std::cref(f), false);
+    benchmark::RegisterBenchmark(("pretty_print_json/color/" + f.name).c_str(), bm_pretty_print_json, std::cref(f), true);
+  }
+}
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace jwt
+
+int main(int argc, char** argv)
+{
+  // Our own flag, which must go before google benchmark sees the rest.
+  int kept = 1;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--perf_counters") == 0)
+    {
+      std::string error;
+      if (!jwt::bench::enable_perf_counters(error))
+      {
+        std::cerr << "Hardware counters unavailable: " << error << std::endl;
+        return 1;
+      }
+      continue;
+    }
+    argv[kept++] = argv[i];
+  }
+  argc = kept;
+
+  static const auto fixtures = jwt::bench::make_fixtures();
+  jwt::bench::register_benchmarks(fixtures);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+  {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
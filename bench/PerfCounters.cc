@@ -0,0 +1,169 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#  include <cerrno>
+#  include <cstring>
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace jwt {
+namespace bench {
+
+namespace {
+
+#if defined(__linux__)
+
+constexpr int kNumCounters = 4;
+
+// The group leader counts cycles; the others are read along with it.
+int g_leader_fd = -1;
+
+int open_counter(std::uint64_t config, int group_fd)
+{
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+#endif
+
+} // anonymous namespace
+
+bool enable_perf_counters(std::string& error)
+{
+#if defined(__linux__)
+  const std::uint64_t configs[kNumCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+  };
+
+  int fds[kNumCounters];
+  for (int i = 0; i < kNumCounters; ++i)
+  {
+    fds[i] = open_counter(configs[i], i == 0 ? -1 : fds[0]);
+    if (fds[i] == -1)
+    {
+      error = std::string{"perf_event_open failed: "} + std::strerror(errno);
+      if (errno == EACCES || errno == EPERM)
+      {
+        error += " (see /proc/sys/kernel/perf_event_paranoid)";
+      }
+      else if (errno == ENOENT || errno == EOPNOTSUPP)
+      {
+        error += " (no hardware counters, e.g. in a VM without a virtual PMU)";
+      }
+      while (i-- > 0)
+      {
+        close(fds[i]);
+      }
+      return false;
+    }
+  }
+
+  g_leader_fd = fds[0];
+  ioctl(g_leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(g_leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+#else
+  error = "hardware counters are only supported on Linux";
+  return false;
+#endif
+}
+
+PerfSample PerfSample::now()
+{
+  PerfSample sample;
+
+#if defined(__linux__)
+  if (g_leader_fd == -1)
+  {
+    return sample;
+  }
+
+  struct
+  {
+    std::uint64_t nr;
+    std::uint64_t time_enabled;
+    std::uint64_t time_running;
+    std::uint64_t values[kNumCounters];
+  } data;
+
+  if (read(g_leader_fd, &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data.time_running == 0)
+  {
+    return sample;
+  }
+
+  // Scale up if the kernel had to multiplex the PMU with someone else.
+  auto scale = [&](std::uint64_t value) {
+    return static_cast<std::uint64_t>(static_cast<double>(value) * data.time_enabled / data.time_running);
+  };
+
+  sample.valid = true;
+  sample.cycles = scale(data.values[0]);
+  sample.instructions = scale(data.values[1]);
+  sample.cache_misses = scale(data.values[2]);
+  sample.branch_misses = scale(data.values[3]);
+#endif
+
+  return sample;
+}
+
+void report_perf_counters(benchmark::State& state, const PerfSample& start)
+{
+  if (!start.valid)
+  {
+    return;
+  }
+
+  auto end = PerfSample::now();
+  if (!end.valid)
+  {
+    return;
+  }
+
+  auto per_iteration = [&](std::uint64_t delta) {
+    return benchmark::Counter(static_cast<double>(delta), benchmark::Counter::kAvgIterations);
+  };
+
+  auto cycles = end.cycles - start.cycles;
+  auto instructions = end.instructions - start.instructions;
+
+  state.counters["cycles"] = per_iteration(cycles);
+  state.counters["instructions"] = per_iteration(instructions);
+  state.counters["cache_misses"] = per_iteration(end.cache_misses - start.cache_misses);
+  state.counters["branch_misses"] = per_iteration(end.branch_misses - start.branch_misses);
+  state.counters["IPC"] = cycles > 0 ? static_cast<double>(instructions) / cycles : 0.0;
+}
+
+} // namespace bench
+} // namespace jwt
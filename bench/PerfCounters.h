@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_BENCH_PERFCOUNTERS_H
+#define JWT_BENCH_PERFCOUNTERS_H
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+namespace jwt {
+namespace bench {
+
+// A snapshot of this thread's hardware counters, as read through Linux's
+// perf_event_open.  Invalid unless enable_perf_counters() succeeded.
+struct PerfSample
+{
+  bool valid {false};
+  std::uint64_t cycles {0};
+  std::uint64_t instructions {0};
+  std::uint64_t cache_misses {0};
+  std::uint64_t branch_misses {0};
+
+  static PerfSample now();
+};
+
+// Starts counting cycles, instructions, cache misses and branch misses in
+// user space on the calling thread.  Returns false, with the reason in
+// `error`, when the kernel refuses or the platform is not Linux.
+bool enable_perf_counters(std::string& error);
+
+// Reports counts since `start` per iteration, plus instructions per cycle.
+// Does nothing if `start` is invalid.
+void report_perf_counters(benchmark::State& state, const PerfSample& start);
+
+} // namespace bench
+} // namespace jwt
+
+#endif // JWT_BENCH_PERFCOUNTERS_H
@@ -0,0 +1,17 @@
+include(FetchContent)
+
+# Prefer an installed copy; building google/benchmark from source is slow.
+find_package(benchmark QUIET)
+
+if (NOT benchmark_FOUND)
+  FetchContent_Declare(
+    benchmark
+    URL https://github.com/google/benchmark/archive/refs/tags/v1.8.3.zip
+  )
+
+  set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+  FetchContent_MakeAvailable(benchmark)
+endif()
@@ -0,0 +1,477 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "libjwt/JsonVisitor.h"
+
+#include "Base64.h"
+
+class UsageError : public std::runtime_error
+{
+public:
+  UsageError(const std::string& what) : std::runtime_error(what)
+  {}
+};
+
+void usage()
+{
+  std::string lines[] = {
+    "Generates a deterministic corpus of JWTs, one per line.",
+    "",
+    "jwt_gen [options]",
+    "",
+    "  -h OR --help              Displays this message.",
+    "  -n OR --count N           Number of tokens to write (default 1000).",
+    "  -s OR --seed N            Random seed (default 1).",
+    "  -o OR --output FILE       Writes to FILE instead of stdout.",
+    "  --claims N                Claims per payload (default 8).",
+    "  --depth N                 Maximum nesting depth of claim values (default 1).",
+    "  --string-length N         Average length of string values (default 16).",
+    "  --unicode F               Fraction of strings with non-ASCII text (default 0.1).",
+    "  --headers N               Number of distinct headers to use (default 4).",
+    "  --malformed F             Fraction of lines that are not valid tokens (default 0).",
+    "",
+    "The same options and seed always produce the same output."
+  };
+
+  for (auto&& line : lines)
+  {
+    std::cerr << line << std::endl;
+  }
+}
+
+namespace {
+
+// xoshiro256** seeded through splitmix64.  std::mt19937's distributions are
+// implementation-defined, so they would give different corpora on different
+// standard libraries.
+class Random
+{
+public:
+  explicit Random(std::uint64_t seed)
+  {
+    for (auto& word : state_)
+    {
+      seed += 0x9E3779B97F4A7C15ull;
+      auto z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  std::uint64_t next()
+  {
+    auto result = rotl(state_[1] * 5, 7) * 9;
+    auto t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+
+    return result;
+  }
+
+  // Returns a value in [0, bound).
+  std::uint64_t below(std::uint64_t bound)
+  {
+    return bound == 0 ? 0 : next() % bound;
+  }
+
+  // Returns a value in [0, 1).
+  double fraction()
+  {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  bool chance(double probability)
+  {
+    return fraction() < probability;
+  }
+
+private:
+  static std::uint64_t rotl(std::uint64_t x, int k)
+  {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  std::uint64_t state_[4];
+};
+
+struct Options
+{
+  std::uint64_t count {1000};
+  std::uint64_t seed {1};
+  std::string output;
+  std::uint64_t claims {8};
+  std::uint64_t depth {1};
+  std::uint64_t string_length {16};
+  double unicode {0.1};
+  std::uint64_t headers {4};
+  double malformed {0.0};
+};
+
+class Generator
+{
+public:
+  explicit Generator(const Options& options)
+    : options_(options)
+    , random_(options.seed)
+  {
+    static const char* algorithms[] = {"HS256", "RS256", "ES256", "PS256", "EdDSA", "HS512"};
+
+    auto num_headers = options_.headers > 0 ? options_.headers : 1;
+    for (std::uint64_t i = 0; i < num_headers; ++i)
+    {
+      jwt::ordered_json header;
+      header["alg"] = algorithms[i % (sizeof(algorithms) / sizeof(algorithms[0]))];
+      header["typ"] = "JWT";
+      if (i > 0)
+      {
+        header["kid"] = "key-" + std::to_string(i);
+      }
+      headers_.push_back(jwt::base64_urlsafe_encode(header.dump()));
+      signature_sizes_.push_back(signature_size(header["alg"].get<std::string>()));
+    }
+  }
+
+  // Replaces `line` with the next line of the corpus.
+  void next(std::string& line)
+  {
+    auto header = random_.below(headers_.size());
+
+    line = headers_[header];
+    line += '.';
+    line += jwt::base64_urlsafe_encode(make_payload().dump());
+    line += '.';
+    line += jwt::base64_urlsafe_encode(random_bytes(signature_sizes_[header]));
+
+    if (random_.chance(options_.malformed))
+    {
+      corrupt(line);
+    }
+  }
+
+private:
+  static std::size_t signature_size(const std::string& alg)
+  {
+    if (alg == "RS256" || alg == "PS256") return 256;
+    if (alg == "ES256" || alg == "HS512" || alg == "EdDSA") return 64;
+    return 32;
+  }
+
+  jwt::ordered_json make_payload()
+  {
+    static const char* registered[] = {"iss", "sub", "aud", "exp", "nbf", "iat", "jti"};
+
+    auto iat = 1700000000 + static_cast<std::int64_t>(random_.below(30 * 86400));
+    static const std::int64_t lifetimes[] = {300, 900, 3600, 86400};
+
+    jwt::ordered_json payload = jwt::ordered_json::object();
+    for (std::uint64_t i = 0; i < options_.claims; ++i)
+    {
+      if (i >= sizeof(registered) / sizeof(registered[0]))
+      {
+        payload["claim_" + std::to_string(i)] = make_value(options_.depth);
+        continue;
+      }
+
+      std::string name = registered[i];
+      if (name == "iss")
+      {
+        payload[name] = "https://issuer-" + std::to_string(random_.below(8)) + ".example.com";
+      }
+      else if (name == "sub")
+      {
+        payload[name] = std::to_string(random_.below(1000000));
+      }
+      else if (name == "aud")
+      {
+        payload[name] = "service-" + std::to_string(random_.below(16));
+      }
+      else if (name == "exp")
+      {
+        payload[name] = iat + lifetimes[random_.below(4)];
+      }
+      else if (name == "nbf" || name == "iat")
+      {
+        payload[name] = iat;
+      }
+      else
+      {
+        payload[name] = make_string();
+      }
+    }
+    return payload;
+  }
+
+  jwt::ordered_json make_value(std::uint64_t depth)
+  {
+    auto kind = random_.below(depth > 0 ? 7 : 5);
+    switch (kind)
+    {
+      case 0:
+        return make_string();
+      case 1:
+        return static_cast<std::int64_t>(random_.next() % 2000000) - 1000000;
+      case 2:
+        return random_.fraction() * 1000;
+      case 3:
+        return random_.chance(0.5);
+      case 4:
+        return nullptr;
+      case 5:
+      {
+        auto array = jwt::ordered_json::array();
+        for (auto n = random_.below(5); n > 0; --n)
+        {
+          array.push_back(make_value(depth - 1));
+        }
+        return array;
+      }
+      default:
+      {
+        auto object = jwt::ordered_json::object();
+        for (auto n = random_.below(5); n > 0; --n)
+        {
+          object["k" + std::to_string(n)] = make_value(depth - 1);
+        }
+        return object;
+      }
+    }
+  }
+
+  std::string make_string()
+  {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 -_";
+    static const char* non_ascii[] = {"é", "ß", "中", "文", "✓", "\U0001F600"};
+
+    auto length = 1 + random_.below(2 * options_.string_length);
+    bool unicode = random_.chance(options_.unicode);
+
+    std::string text;
+    for (std::uint64_t i = 0; i < length; ++i)
+    {
+      if (unicode && random_.chance(0.25))
+      {
+        text += non_ascii[random_.below(sizeof(non_ascii) / sizeof(non_ascii[0]))];
+      }
+      else
+      {
+        text += alphabet[random_.below(sizeof(alphabet) - 1)];
+      }
+    }
+    return text;
+  }
+
+  std::string random_bytes(std::size_t size)
+  {
+    std::string bytes(size, '\0');
+    for (auto& byte : bytes)
+    {
+      byte = static_cast<char>(random_.next() & 0xFF);
+    }
+    return bytes;
+  }
+
+  void corrupt(std::string& line)
+  {
+    // The signature is opaque to a decoder, so damage to it would still
+    // decode; truncation and bad characters only land in the header or
+    // payload.
+    auto signature = line.rfind('.');
+    switch (random_.below(5))
+    {
+      case 0:
+        // Truncated mid-token
+        line.resize(random_.below(signature));
+        break;
+      case 1:
+        // A character outside the base64url alphabet
+        line[random_.below(signature)] = '!';
+        break;
+      case 2:
+        // A missing segment
+        line.erase(0, line.find('.') + 1);
+        break;
+      case 3:
+        // A payload that isn't valid JSON
+        line = headers_[0] + "." + jwt::base64_urlsafe_encode("{\"sub\":") + ".";
+        break;
+      default:
+        // Not a token at all
+        line = "eyJ" + make_string();
+        break;
+    }
+  }
+
+  const Options& options_;
+  Random random_;
+
+  std::vector<std::string> headers_;
+  std::vector<std::size_t> signature_sizes_;
+};
+
+std::uint64_t parse_count(const char* opt, const char* value)
+{
+  char* end;
+  auto result = std::strtoull(value, &end, 10);
+  if (*value == '\0' || *end != '\0')
+  {
+    throw UsageError(std::string{"Expected a number for "} + opt);
+  }
+  return result;
+}
+
+double parse_fraction(const char* opt, const char* value)
+{
+  char* end;
+  auto result = std::strtod(value, &end);
+  if (*value == '\0' || *end != '\0' || result < 0.0 || result > 1.0)
+  {
+    throw UsageError(std::string{"Expected a fraction between 0 and 1 for "} + opt);
+  }
+  return result;
+}
+
+Options parse_options(int argc, char** argv)
+{
+  Options options;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    char* opt = argv[i];
+    if (strcmp("-h", opt) == 0 || strcmp("--help", opt) == 0)
+    {
+      usage();
+      exit(0);
+    }
+
+    if (i == argc - 1)
+    {
+      throw UsageError(std::string{"Missing value for "} + opt);
+    }
+    char* value = argv[++i];
+
+    if (strcmp("-n", opt) == 0 || strcmp("--count", opt) == 0)
+    {
+      options.count = parse_count(opt, value);
+    }
+    else if (strcmp("-s", opt) == 0 || strcmp("--seed", opt) == 0)
+    {
+      options.seed = parse_count(opt, value);
+    }
+    else if (strcmp("-o", opt) == 0 || strcmp("--output", opt) == 0)
+    {
+      options.output = value;
+    }
+    else if (strcmp("--claims", opt) == 0)
+    {
+      options.claims = parse_count(opt, value);
+    }
+    else if (strcmp("--depth", opt) == 0)
+    {
+      options.depth = parse_count(opt, value);
+    }
+    else if (strcmp("--string-length", opt) == 0)
+    {
+      options.string_length = parse_count(opt, value);
+    }
+    else if (strcmp("--unicode", opt) == 0)
+    {
+      options.unicode = parse_fraction(opt, value);
+    }
+    else if (strcmp("--headers", opt) == 0)
+    {
+      options.headers = parse_count(opt, value);
+    }
+    else if (strcmp("--malformed", opt) == 0)
+    {
+      options.malformed = parse_fraction(opt, value);
+    }
+    else
+    {
+      throw UsageError(std::string{"Unrecognized option: "} + opt);
+    }
+  }
+
+  return options;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    auto options = parse_options(argc, argv);
+
+    FILE* out = stdout;
+    if (!options.output.empty())
+    {
+      out = std::fopen(options.output.c_str(), "wb");
+      if (out == nullptr)
+      {
+        throw std::runtime_error{"Could not open " + options.output};
+      }
+    }
+
+    static char buffer[1 << 20];
+    std::setvbuf(out, buffer, _IOFBF, sizeof(buffer));
+
+    Generator generator{options};
+    std::string line;
+    for (std::uint64_t i = 0; i < options.count; ++i)
+    {
+      generator.next(line);
+      line += '\n';
+      if (std::fwrite(line.data(), 1, line.size(), out) != line.size())
+      {
+        throw std::runtime_error{"Error writing output"};
+      }
+    }
+
+    if (std::fflush(out) != 0 || (out != stdout && std::fclose(out) != 0))
+    {
+      throw std::runtime_error{"Error writing output"};
+    }
+  }
+  catch (const UsageError& ex)
+  {
+    std::cerr << ex.what() << std::endl;
+    usage();
+    return 1;
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "FATAL ERROR: " << ex.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,48 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_BINARYFORMAT_H
+#define JWT_LIB_BINARYFORMAT_H
+
+#pragma once
+
+#include <string>
+
+#include "libjwt/Jwt.h"
+
+namespace jwt {
+
+enum class BinaryFormat
+{
+  Cbor,
+  MessagePack,
+};
+
+// Appends `token` to `out` as one frame: a 4-byte big-endian length, then a
+// CBOR or MessagePack map shaped like the server's JSON responses, i.e.
+// {"header":...,"payload":...,"signature":...}, or for a JWE the header
+// followed by its encrypted_key, initialization_vector, ciphertext and
+// authentication_tag.
+//
+// The map's keys are written directly and the header and payload are encoded
+// from the parsed JSON as they are, without first assembling a document
+// around them.
+void append_frame(std::string& out, const Jwt& token, BinaryFormat format);
+
+} // namespace jwt
+
+#endif // JWT_LIB_BINARYFORMAT_H
@@ -0,0 +1,169 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_CLAIMINDEX_H
+#define JWT_LIB_CLAIMINDEX_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "libjwt/ClaimTable.h"
+#include "libjwt/Jwt.h"
+
+namespace jwt {
+
+// One token in an index: its "iss", "sub" and "exp", and where it was found.
+// Strings are ids into the index's sorted string table, so that comparing
+// ids compares the strings; 0 means the claim is missing, as does an `exp`
+// of kNoExpiry.
+struct IndexEntry
+{
+  std::uint32_t iss;
+  std::uint32_t sub;
+  std::int64_t exp;
+  std::uint64_t offset;
+
+  // 1-based, or 0 if unknown, e.g. for tokens in a file scanned in parts.
+  std::uint64_t line;
+
+  std::uint32_t source;
+  std::uint32_t length;
+};
+
+constexpr std::int64_t kNoExpiry = std::numeric_limits<std::int64_t>::min();
+
+// Collects tokens for an index until it is written out, one builder per
+// thread.
+//
+// The entries for terabytes of logs would not fit in memory, so a builder
+// given a `run_path` sorts each `run_size` entries it collects and appends
+// them to that file as a run; write() merges the runs of every builder into
+// the index.  Only the distinct "iss" and "sub" strings stay in memory.
+class ClaimIndexBuilder
+{
+public:
+  // Entries per run, 40 MiB of them.
+  static constexpr std::size_t kRunSize = 1 << 20;
+
+  // Without a `run_path`, all entries stay in memory.  The builder removes
+  // its run file when it is destroyed.
+  explicit ClaimIndexBuilder(std::string run_path = {}, std::size_t run_size = kRunSize);
+  ~ClaimIndexBuilder();
+
+  ClaimIndexBuilder(const ClaimIndexBuilder&) = delete;
+  ClaimIndexBuilder& operator=(const ClaimIndexBuilder&) = delete;
+
+  // Adds `token`, found `length` bytes long at `offset` and `line` of the
+  // source numbered `source`.
+  void add(const Jwt& token, std::uint32_t source, std::uint64_t offset, std::uint64_t line, std::uint32_t length);
+
+  std::size_t size() const { return spilled_ + entries_.size(); }
+
+  // Writes the index of every token in `builders`, sorted by iss, sub and
+  // exp, naming the sources by `paths`.
+  static void write(std::ostream& os, const std::vector<ClaimIndexBuilder*>& builders, const std::vector<std::string>& paths);
+
+private:
+  // A sorted run of entries in the run file, counted in entries.
+  struct Run
+  {
+    std::uint64_t begin;
+    std::uint64_t size;
+  };
+
+  class Cursor;
+
+  std::uint32_t intern(std::string_view text);
+  void sort_entries();
+  void spill();
+
+  std::unordered_map<std::string, std::uint32_t> ids_;
+  std::vector<const std::string*> strings_;
+  std::vector<IndexEntry> entries_;
+
+  std::string run_path_;
+  std::size_t run_size_;
+  std::fstream run_file_;
+  std::vector<Run> runs_;
+  std::uint64_t spilled_ {0};
+
+  std::string key_;
+  std::string scratch_;
+};
+
+// Reads an index from memory, such as a mapped file.
+//
+// Entries are sorted by iss, sub and exp, so looking up an issuer, a subject
+// of an issuer, or a range of expiry times of either, is a binary search.  A
+// subject without an issuer is looked up within each issuer in turn, which
+// are few.  Without a subject, a range of expiry times is scanned for.
+class ClaimIndex
+{
+public:
+  // `data` must outlive the index.  Throws InputError if it is not an index,
+  // or a truncated or damaged one.
+  explicit ClaimIndex(std::string_view data);
+
+  std::size_t size() const { return entries_; }
+
+  // The path of source `source`, as given when the index was built.
+  std::string_view source(std::uint32_t source) const;
+
+  // The string with id `id`, or empty for 0.
+  std::string_view string(std::uint32_t id) const;
+
+  using EntryCallback = std::function<void(const IndexEntry& entry)>;
+
+  // Calls `on_entry` for each entry that matches all of `conditions`, in
+  // index order.  Only iss=, sub= and comparisons of exp are supported;
+  // anything else throws InputError.
+  void query(const std::vector<ClaimCondition>& conditions, const EntryCallback& on_entry) const;
+
+private:
+  IndexEntry entry(std::size_t i) const;
+  bool find_string(std::string_view text, std::uint32_t& id) const;
+
+  template <typename Before>
+  std::size_t partition_point(std::size_t first, std::size_t last, Before&& before) const;
+
+  std::size_t entries_ {0};
+  const char* entry_data_ {nullptr};
+
+  std::size_t strings_ {0};
+  const char* string_offsets_ {nullptr};
+  const char* string_chars_ {nullptr};
+  std::size_t string_chars_size_ {0};
+
+  std::size_t sources_ {0};
+  const char* source_offsets_ {nullptr};
+  const char* source_chars_ {nullptr};
+  std::size_t source_chars_size_ {0};
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_CLAIMINDEX_H
@@ -0,0 +1,83 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_CLAIMSUMMARY_H
+#define JWT_LIB_CLAIMSUMMARY_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "libjwt/JsonVisitor.h"
+#include "libjwt/Jwt.h"
+#include "libjwt/Sketches.h"
+
+namespace jwt {
+
+// Folds decoded tokens into statistics whose size does not grow with the
+// number of tokens:
+//
+// - exact counts per header "alg" and "kid" and per "iss",
+// - estimated numbers of distinct "sub" and "jti" values,
+// - the most frequent "sub" and "aud" values, and
+// - a histogram of lifetimes, "exp" - "iat", in seconds.
+//
+// Only the exact counts grow, with the number of distinct algorithms, keys
+// and issuers.  Summaries built on separate threads can be merged.
+class ClaimSummary
+{
+public:
+  // How many of the most frequent values to report, out of `kTopKCapacity`
+  // tracked.
+  static constexpr std::size_t kTopK = 10;
+  static constexpr std::size_t kTopKCapacity = 1000;
+
+  ClaimSummary();
+
+  void add(const Jwt& token);
+  void merge(const ClaimSummary& other);
+
+  // The statistics as a JSON object, with counts sorted most frequent first.
+  ordered_json to_json() const;
+
+private:
+  using Counts = std::unordered_map<std::string, std::uint64_t>;
+
+  std::uint64_t tokens_ {0};
+  std::uint64_t encrypted_ {0};
+
+  Counts algorithms_;
+  Counts key_ids_;
+  Counts issuers_;
+
+  HyperLogLog subjects_;
+  HyperLogLog token_ids_;
+
+  TopK top_subjects_;
+  TopK top_audiences_;
+
+  Log2Histogram lifetimes_;
+  std::uint64_t negative_lifetimes_ {0};
+  std::uint64_t missing_lifetimes_ {0};
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_CLAIMSUMMARY_H
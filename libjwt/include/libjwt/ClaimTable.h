@@ -0,0 +1,202 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_CLAIMTABLE_H
+#define JWT_LIB_CLAIMTABLE_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "libjwt/Jwt.h"
+
+namespace jwt {
+
+// The columns of a claim table: the header's "alg", "kid" and "typ", the
+// payload's "iss", "sub", "aud" and "jti" as strings, its "iat", "nbf" and
+// "exp" as integers, and everything else as compact JSON.
+enum class ClaimColumn
+{
+  Alg,
+  Kid,
+  Typ,
+  Iss,
+  Sub,
+  Aud,
+  Jti,
+  Iat,
+  Nbf,
+  Exp,
+  OtherHeader,
+  OtherClaims,
+};
+
+constexpr std::size_t kClaimColumnCount = 12;
+
+// The column's name, e.g. "iss" or "other_claims".
+std::string_view column_name(ClaimColumn column);
+
+// Looks up a column by name, returning false if there is none.
+bool find_column(std::string_view name, ClaimColumn& column);
+
+// A filter on one string or integer column, e.g. "iss=https://a" or
+// "exp>=1792317600".  Strings can only be compared with = and !=.  A row
+// without the claim matches no condition on it, not even !=.
+struct ClaimCondition
+{
+  enum class Op
+  {
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+  };
+
+  ClaimColumn column;
+  Op op;
+  std::string text;
+  std::int64_t number {0};
+
+  // Throws InputError if `text` is not a condition on such a column.
+  static ClaimCondition parse(std::string_view text);
+};
+
+// Writes decoded claims as a claim table: a file that can be queried again
+// and again without any base64 or JSON decoding.
+//
+// The file is a short header followed by self-contained blocks of up to
+// kBlockRows rows, each stored column by column.  String columns are
+// dictionary-encoded per block, integer columns are plain int64 arrays with
+// their minimum and maximum in the block header, and the leftover JSON is
+// stored as text.  Values that do not fit their column, such as an array
+// "aud" or a fractional "exp", stay in the leftover JSON, so nothing is lost.
+//
+// Blocks are written through a sink as they fill up, so writers on separate
+// threads can share one file, in which case rows are not in input order.
+class ClaimTableWriter
+{
+public:
+  static constexpr std::size_t kBlockRows = 65536;
+
+  using BlockSink = std::function<void(std::string_view block)>;
+
+  explicit ClaimTableWriter(BlockSink sink, std::size_t block_rows = kBlockRows);
+
+  ClaimTableWriter(const ClaimTableWriter&) = delete;
+  ClaimTableWriter& operator=(const ClaimTableWriter&) = delete;
+
+  // What a claim table starts with, to write once before any block.
+  static std::string_view file_header();
+
+  void add(const Jwt& token);
+
+  // Writes the rows added since the last block, if any.
+  void finish();
+
+private:
+  struct StringColumn
+  {
+    std::unordered_map<std::string, std::uint32_t> codes;
+    std::vector<std::uint32_t> offsets {0};
+    std::string chars;
+    std::vector<std::uint32_t> values;
+  };
+
+  struct TextColumn
+  {
+    std::vector<std::uint32_t> offsets {0};
+    std::string chars;
+  };
+
+  void add_string(StringColumn& column, const ordered_json* value);
+  void add_integer(std::vector<std::int64_t>& column, const ordered_json* value);
+  void add_rest(TextColumn& column, const ordered_json& object, std::size_t first, std::size_t last);
+  void write_block();
+
+  BlockSink sink_;
+  std::size_t block_rows_;
+  std::size_t rows_ {0};
+
+  StringColumn strings_[7];
+  std::vector<std::int64_t> integers_[3];
+  TextColumn rest_[2];
+
+  std::string key_;
+  std::string block_;
+};
+
+// Reads a claim table from memory, such as a mapped file.
+class ClaimTable
+{
+  struct Block;
+
+public:
+  // One row of a block, valid as long as the table.
+  class Row
+  {
+  public:
+    bool has(ClaimColumn column) const;
+
+    // A string or leftover JSON column's value, or an integer column's value
+    // formatted into `scratch`.  Empty if the row has no such value.
+    std::string_view text(ClaimColumn column, std::string& scratch) const;
+
+    // The value of "iat", "nbf" or "exp"; only meaningful if has(column).
+    std::int64_t number(ClaimColumn column) const;
+
+  private:
+    friend class ClaimTable;
+
+    Row(const Block& block, std::uint32_t row) : block_(&block), row_(row) {}
+
+    const Block* block_;
+    std::uint32_t row_;
+  };
+
+  using RowCallback = std::function<void(const Row& row)>;
+
+  // `data` must outlive the table.  Throws InputError if it is not a claim
+  // table, or a truncated or damaged one.
+  explicit ClaimTable(std::string_view data);
+  ~ClaimTable();
+
+  ClaimTable(const ClaimTable&) = delete;
+  ClaimTable& operator=(const ClaimTable&) = delete;
+
+  std::uint64_t rows() const { return rows_; }
+
+  // Calls `on_row` for each row that matches all of `conditions`, in file
+  // order.  Blocks whose dictionaries or integer ranges rule a condition out
+  // are skipped without looking at their rows.
+  void query(const std::vector<ClaimCondition>& conditions, const RowCallback& on_row) const;
+
+private:
+  std::vector<Block> blocks_;
+  std::uint64_t rows_ {0};
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_CLAIMTABLE_H
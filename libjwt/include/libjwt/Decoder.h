@@ -0,0 +1,79 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_DECODER_H
+#define JWT_LIB_DECODER_H
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libjwt/BinaryFormat.h"
+#include "libjwt/JsonPrinter.h"
+#include "libjwt/JsonVisitor.h"
+#include "libjwt/Jwt.h"
+#include "libjwt/JwtError.h"
+
+namespace jwt {
+
+// Decodes and prints many tokens in a row, keeping scratch state between
+// calls.
+//
+// Base64 output is written straight into the target Jwt's strings, so reusing
+// one Jwt recycles their capacity.  The JSON parser's container stack and the
+// printers' context stacks live here.  Only the ordered_json nodes themselves
+// are still allocated per token; use a Tape if that matters.
+//
+// A Decoder is not thread-safe; give each thread its own.
+class Decoder
+{
+public:
+  Decoder();
+  ~Decoder();
+
+  // Parses `encoded` into `out`, overwriting its previous contents.  Throws
+  // InputError if the token is malformed.
+  void parse_into(std::string_view encoded, Jwt& out);
+
+  // Like parse_into(), but never throws.  On failure, `out` is left in an
+  // unspecified but valid state.
+  bool try_parse_into(std::string_view encoded, Jwt& out, JwtError& error);
+
+  std::ostream& print(std::ostream& os, const ordered_json& json, bool use_ansi_colors);
+
+  // Writes `token` as one length-prefixed CBOR or MessagePack frame; see
+  // append_frame().
+  std::ostream& print_binary(std::ostream& os, const Jwt& token, BinaryFormat format);
+
+private:
+  bool decode(std::string_view encoded, Jwt& out, JwtError& error);
+
+  std::vector<ordered_json*> json_stack_;
+
+  std::unique_ptr<JsonPrinter> printer_;
+  std::unique_ptr<JsonPrinter> ansi_printer_;
+
+  std::string frame_;
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_DECODER_H
@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_DISTINCTTOKENS_H
+#define JWT_LIB_DISTINCTTOKENS_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "libjwt/Hash.h"
+
+namespace jwt {
+
+// Counts how often each distinct token occurs, keeping its text and where it
+// was first seen, so that repeats need not be decoded.
+//
+// Tokens are told apart by a 128-bit hash of their text; two tokens would
+// have to collide in all 128 bits to be confused.  Any number of threads may
+// add at once: the table is split into shards by hash, each an
+// open-addressing table under its own lock, so threads rarely wait.  Which
+// occurrence is "first" is decided by position rather than timing, so the
+// result does not depend on how the work was divided.
+class DistinctTokens
+{
+public:
+  struct Position
+  {
+    // E.g. the index of the input file, then the byte offset and line in it.
+    std::uint32_t source {0};
+    std::uint64_t offset {0};
+    std::uint64_t line {0};
+
+    bool operator<(const Position& other) const
+    {
+      return std::tie(source, offset) < std::tie(other.source, other.offset);
+    }
+  };
+
+  struct Entry
+  {
+    std::string text;
+    Position first;
+    std::uint64_t count {0};
+  };
+
+  explicit DistinctTokens(std::size_t num_shards = 64);
+  ~DistinctTokens();
+
+  DistinctTokens(const DistinctTokens&) = delete;
+  DistinctTokens& operator=(const DistinctTokens&) = delete;
+
+  void add(std::string_view token, const Position& position);
+
+  // Every distinct token, ordered by where it was first seen.  Only call this
+  // once the adding threads are done.
+  std::vector<Entry> entries() const;
+
+private:
+  struct Shard;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_DISTINCTTOKENS_H
@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_HASH_H
+#define JWT_LIB_HASH_H
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace jwt {
+
+// A 128-bit hash, wide enough to stand in for a token's identity.
+struct Hash128
+{
+  std::uint64_t low {0};
+  std::uint64_t high {0};
+
+  bool operator==(const Hash128& other) const { return low == other.low && high == other.high; }
+  bool operator!=(const Hash128& other) const { return !(*this == other); }
+};
+
+// MurmurHash3's x64 128-bit variant.  Fast and well mixed in every bit, but
+// not cryptographic: do not rely on it against inputs chosen to collide.
+Hash128 murmur3_128(std::string_view data, std::uint32_t seed = 0);
+
+} // namespace jwt
+
+#endif // JWT_LIB_HASH_H
@@ -20,14 +20,34 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
 #include <iosfwd>
+#include <memory>
 #include <string>
 
 #include "libjwt/JsonVisitor.h"
+#include "libjwt/Tape.h"
 
 namespace jwt {
 
+class PrintingJsonVisitor;
+
+// Pretty-prints JSON documents, keeping its scratch state between calls.
+class JsonPrinter
+{
+public:
+  explicit JsonPrinter(bool use_ansi_colors);
+  ~JsonPrinter();
+
+  std::ostream& print(std::ostream& os, const ordered_json& json);
+  std::ostream& print(std::ostream& os, const Tape& tape, std::size_t root);
+
+private:
+  std::unique_ptr<PrintingJsonVisitor> visitor_;
+};
+
 std::ostream& pretty_print_json(std::ostream& os, const ordered_json& json, bool use_ansi_colors);
+std::ostream& pretty_print_json(std::ostream& os, const Tape& tape, std::size_t root, bool use_ansi_colors);
 
 } // namespace jwt
 
@@ -18,22 +18,35 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef JWT_LIB_JWT_H
 #define JWT_LIB_JWT_H
 
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "libjwt/JsonVisitor.h"
+#include "libjwt/JwtError.h"
 
 namespace jwt {
 
 class Jwt
 {
 public:
-  Jwt(const std::string& original_header,
-      const std::string& original_payload,
-      const std::string& signature,
-      const ordered_json& header,
-      const ordered_json& payload);
+  // An empty token, to be filled in by Decoder::parse_into.
+  Jwt() = default;
 
-  static Jwt parse(const std::string& encoded);
+  Jwt(std::string original_header,
+      std::string original_payload,
+      std::string signature,
+      ordered_json header,
+      ordered_json payload);
+
+  // Parses a JWS, or the header of a JWE, in compact serialization.  Throws
+  // InputError if the token is malformed.
+  static Jwt parse(std::string_view encoded);
+
+  // Like parse(), but never throws; on failure, returns nothing and describes
+  // the problem in `error`.  Prefer this when many inputs are expected to be
+  // garbage, e.g. when scanning logs.
+  static std::optional<Jwt> try_parse(std::string_view encoded, JwtError& error);
 
   const std::string& original_header() const { return original_header_; }
   const std::string& original_payload() const { return original_payload_; }
@@ -42,16 +55,30 @@ public:
   const ordered_json& header() const { return header_; }
   const ordered_json& payload() const { return payload_; }
 
+  // The remaining segments of a JWE, still base64url-encoded.  These are
+  // empty for a JWS.
+  const std::string& encrypted_key() const { return encrypted_key_; }
+  const std::string& initialization_vector() const { return initialization_vector_; }
+  const std::string& ciphertext() const { return ciphertext_; }
+  const std::string& authentication_tag() const { return authentication_tag_; }
+
   bool is_encrypted() const;
   bool is_signed() const;
 
 private:
+  friend class Decoder;
+
   std::string original_header_;
   std::string original_payload_;
   std::string signature_;
 
   ordered_json header_;
   ordered_json payload_;
+
+  std::string encrypted_key_;
+  std::string initialization_vector_;
+  std::string ciphertext_;
+  std::string authentication_tag_;
 };
 
 }
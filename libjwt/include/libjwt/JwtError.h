@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_JWTERROR_H
+#define JWT_LIB_JWTERROR_H
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace jwt {
+
+// Describes why a token could not be parsed, without throwing.
+struct JwtError
+{
+  enum class Code
+  {
+    None,
+    SegmentCount,
+    Base64,
+    Json,
+  };
+
+  enum class Segment
+  {
+    Header,
+    Payload,
+  };
+
+  Code code {Code::None};
+
+  // The segment that failed to decode, for Base64 and Json errors.
+  Segment segment {Segment::Header};
+
+  // For SegmentCount errors, the byte offset of the first extra '.', or of
+  // the end of the token if there are too few segments.  For Base64 errors,
+  // the byte offset of the bad character in the encoded token.  For Json
+  // errors, the byte offset of the error in the decoded segment.
+  std::size_t position {0};
+
+  explicit operator bool() const { return code != Code::None; }
+
+  // Formats a human-readable description.  Only call this when needed; it
+  // allocates.
+  std::string message() const;
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_JWTERROR_H
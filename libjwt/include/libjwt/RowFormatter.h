@@ -0,0 +1,91 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_ROWFORMATTER_H
+#define JWT_LIB_ROWFORMATTER_H
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libjwt/JsonVisitor.h"
+#include "libjwt/Jwt.h"
+
+namespace jwt {
+
+// Writes chosen claims of each token as one line of tab- or comma-separated
+// values, straight from the parsed JSON rather than through a JsonPrinter.
+//
+// A column names a claim in the payload, falling back to the header, or
+// explicitly "header.<name>" or "payload.<name>".  Strings are written as
+// they are, numbers and booleans as JSON literals, objects and arrays as
+// compact JSON, and missing claims as empty fields.  Values are escaped only
+// where the format needs it: TSV uses \t, \n, \r and \\ escapes, CSV quotes
+// fields as in RFC 4180.
+//
+// Formatting keeps no state, so one RowFormatter can serve every thread.
+class RowFormatter
+{
+public:
+  enum class Format
+  {
+    Tsv,
+    Csv,
+  };
+
+  RowFormatter(Format format, const std::vector<std::string>& columns);
+
+  // The line of column names.
+  void write_header(std::ostream& os) const;
+
+  // One line for `token`, ending with a newline.
+  void write_row(std::ostream& os, const Jwt& token) const;
+
+  // One line of values that are already text, one per column, e.g. from a
+  // ClaimTable.
+  void write_row(std::ostream& os, const std::vector<std::string_view>& fields) const;
+
+private:
+  enum class Source
+  {
+    Either,
+    Header,
+    Payload,
+  };
+
+  struct Column
+  {
+    std::string name;
+    std::string claim;
+    Source source;
+  };
+
+  const ordered_json* find(const Jwt& token, const Column& column) const;
+  void write_value(std::ostream& os, const ordered_json& value) const;
+  void write_field(std::ostream& os, std::string_view text) const;
+
+  Format format_;
+  char delimiter_;
+  std::vector<Column> columns_;
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_ROWFORMATTER_H
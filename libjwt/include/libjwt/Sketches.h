@@ -0,0 +1,126 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_SKETCHES_H
+#define JWT_LIB_SKETCHES_H
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace jwt {
+
+// Estimates how many distinct values a stream holds, in 2^precision bytes,
+// with a standard error of about 1.04 / sqrt(2^precision): 0.8% by default.
+class HyperLogLog
+{
+public:
+  explicit HyperLogLog(unsigned precision = 14);
+
+  // Adds a value by its hash, which must be well mixed in every bit.
+  void add(std::uint64_t hash);
+
+  // Folds in a sketch of the same precision, as if its values had been
+  // added here.
+  void merge(const HyperLogLog& other);
+
+  double estimate() const;
+
+private:
+  unsigned precision_;
+  std::vector<std::uint8_t> registers_;
+};
+
+// Tracks the most frequent values in a stream with the Space-Saving
+// algorithm, in room for `capacity` values.  Any value making up more than
+// 1/capacity of the stream is certain to be tracked; each tracked count may
+// overestimate the real one, but by no more than its `error`.
+//
+// Not copyable, since the index refers into the entries.
+class TopK
+{
+public:
+  struct Entry
+  {
+    std::string value;
+    std::uint64_t count;
+    std::uint64_t error;
+  };
+
+  explicit TopK(std::size_t capacity);
+
+  TopK(const TopK&) = delete;
+  TopK& operator=(const TopK&) = delete;
+  TopK(TopK&&) = default;
+  TopK& operator=(TopK&&) = default;
+
+  void add(std::string_view value, std::uint64_t count = 1);
+
+  // Folds in another summary.  The result keeps the guarantees above for the
+  // combined stream.
+  void merge(const TopK& other);
+
+  // The `k` most frequent tracked values, most frequent first.
+  std::vector<Entry> top(std::size_t k) const;
+
+private:
+  void add(std::string_view value, std::uint64_t count, std::uint64_t error);
+  bool heap_less(std::size_t a, std::size_t b) const;
+  void heap_swap(std::size_t a, std::size_t b);
+  void sift_up(std::size_t position);
+  void sift_down(std::size_t position);
+
+  std::size_t capacity_;
+  std::vector<Entry> entries_;
+
+  // A min-heap of indexes into entries_ by count, so that the value to evict
+  // is always at the front, and each entry's position in it.
+  std::vector<std::size_t> heap_;
+  std::vector<std::size_t> heap_positions_;
+
+  // Keys point into entries_, which never reallocates.
+  std::unordered_map<std::string_view, std::size_t> index_;
+};
+
+// Counts values in power-of-two buckets: bucket 0 holds 0, and bucket b > 0
+// holds [2^(b-1), 2^b).  Good enough for durations spanning seconds to years.
+class Log2Histogram
+{
+public:
+  static constexpr std::size_t kNumBuckets = 65;
+
+  void add(std::uint64_t value);
+  void merge(const Log2Histogram& other);
+
+  // The smallest value in `bucket`.
+  static std::uint64_t lower_bound(std::size_t bucket);
+
+  std::uint64_t count(std::size_t bucket) const { return counts_[bucket]; }
+
+private:
+  std::array<std::uint64_t, kNumBuckets> counts_ {};
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_SKETCHES_H
@@ -0,0 +1,145 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef JWT_LIB_STATS_H
+#define JWT_LIB_STATS_H
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include "libjwt/JwtError.h"
+#include "libjwt/Trace.h"
+
+namespace jwt {
+
+// The stages a token passes through on its way from input to output.  libjwt
+// measures Split, Base64Decode, JsonParse and Print itself; the others are
+// up to the caller.
+enum class Phase
+{
+  Read,
+  Split,
+  Base64Decode,
+  JsonParse,
+  Print,
+  Write,
+  Flush,
+};
+
+constexpr std::size_t kNumPhases = 7;
+
+const char* phase_name(Phase phase);
+
+// Calls to operator new, and the bytes they asked for.
+struct AllocationCount
+{
+  std::uint64_t count {0};
+  std::uint64_t bytes {0};
+};
+
+// Whether libjwt was built with JWT_COUNT_ALLOCATIONS, which replaces the
+// global operator new so that each phase also reports its allocations.
+#if defined(JWT_COUNT_ALLOCATIONS)
+constexpr bool kCountsAllocations = true;
+#else
+constexpr bool kCountsAllocations = false;
+#endif
+
+// Allocations made by the calling thread so far.  Always zero unless
+// kCountsAllocations.
+AllocationCount thread_allocations();
+
+// Time and byte counts per phase, plus token and error tallies.  Counters are
+// atomic, so one Stats can be shared by every thread.
+class Stats
+{
+public:
+  struct PhaseTotals
+  {
+    std::chrono::nanoseconds elapsed {0};
+    std::uint64_t bytes {0};
+    std::uint64_t count {0};
+    AllocationCount allocations;
+  };
+
+  void record(Phase phase, std::chrono::nanoseconds elapsed, std::uint64_t bytes, AllocationCount allocations = {});
+  void record_token();
+  void record_error(JwtError::Code code);
+
+  PhaseTotals totals(Phase phase) const;
+  std::uint64_t tokens() const;
+  std::uint64_t errors(JwtError::Code code) const;
+
+  // Writes a human-readable summary, e.g. to stderr at exit.
+  void print_summary(std::ostream& os, std::chrono::nanoseconds wall_time) const;
+
+private:
+  struct Counters
+  {
+    std::atomic<std::int64_t> nanoseconds {0};
+    std::atomic<std::uint64_t> bytes {0};
+    std::atomic<std::uint64_t> count {0};
+    std::atomic<std::uint64_t> allocation_count {0};
+    std::atomic<std::uint64_t> allocation_bytes {0};
+  };
+
+  std::array<Counters, kNumPhases> phases_;
+  std::atomic<std::uint64_t> tokens_ {0};
+  std::array<std::atomic<std::uint64_t>, 4> errors_ {};
+};
+
+// Installs the process-wide Stats that libjwt reports into.  Measurements
+// are off, and cost a single pointer load, while this is null (the default).
+void set_stats(Stats* stats);
+Stats* current_stats();
+
+// The largest resident set size of this process so far, or 0 if unknown.
+std::uint64_t peak_rss_bytes();
+
+// Times one phase into the installed Stats and Trace, if there are any.
+// Phases should not nest, or allocations made in the inner one are counted
+// twice.
+class ScopedPhase
+{
+public:
+  explicit ScopedPhase(Phase phase, std::uint64_t bytes = 0);
+  ~ScopedPhase();
+
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+  void add_bytes(std::uint64_t bytes) { bytes_ += bytes; }
+
+private:
+  Stats* stats_;
+  Trace* trace_;
+  Phase phase_;
+  std::uint64_t bytes_;
+  std::chrono::steady_clock::time_point start_;
+  AllocationCount start_allocations_;
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_STATS_H
@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_TAPE_H
+#define JWT_LIB_TAPE_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libjwt/JsonVisitor.h"
+
+namespace jwt {
+
+// A flat, read-only encoding of one or more JSON documents.
+//
+// Every value is one 64-bit tape word holding a type tag in the top byte and
+// a payload in the rest; numbers take a second word holding their raw bits.
+// Container start words point one past their matching end word, so siblings
+// can be skipped without walking their children.  String bytes live in a
+// single adjacent arena, each prefixed with its 32-bit length.
+//
+// Documents are appended back-to-back, so a batch of tokens can share two
+// buffers instead of one heap node per JSON value.
+class Tape
+{
+public:
+  enum class Type : std::uint8_t
+  {
+    ObjectStart = '{',
+    ObjectEnd = '}',
+    ArrayStart = '[',
+    ArrayEnd = ']',
+    Key = ':',
+    String = '"',
+    SignedNumber = 'l',
+    UnsignedNumber = 'u',
+    FloatingPointNumber = 'd',
+    True = 't',
+    False = 'f',
+    Null = 'n',
+  };
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  // Parses `json` and appends it to the tape, returning the index of the new
+  // document's root value.  Throws the same errors as ordered_json::parse, in
+  // which case the tape is left unchanged.
+  std::size_t parse(std::string_view json);
+
+  // Appends an already-parsed document, returning the index of its root value.
+  std::size_t append(const ordered_json& json);
+
+  void clear();
+
+  bool empty() const { return tape_.empty(); }
+  std::size_t size() const { return tape_.size(); }
+
+  Type type(std::size_t index) const;
+
+  // Returns the index of the value following the one at `index`, skipping
+  // over the contents of objects and arrays.
+  std::size_t next(std::size_t index) const;
+
+  // Valid for Key and String values only.
+  std::string_view get_string(std::size_t index) const;
+
+  std::int64_t get_signed(std::size_t index) const;
+  std::uint64_t get_unsigned(std::size_t index) const;
+  double get_double(std::size_t index) const;
+
+  // Returns the index of the value of field `key` in the object starting at
+  // `object`, or npos if there is no such field.
+  std::size_t find(std::size_t object, std::string_view key) const;
+
+private:
+  friend class TapeBuilder;
+
+  std::vector<std::uint64_t> tape_;
+  std::vector<char> strings_;
+  std::vector<std::size_t> open_containers_;
+};
+
+void visit(const Tape& tape, std::size_t root, IJsonVisitor& visitor);
+
+} // namespace jwt
+
+#endif // JWT_LIB_TAPE_H
@@ -0,0 +1,84 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_TIMEHISTOGRAM_H
+#define JWT_LIB_TIMEHISTOGRAM_H
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "libjwt/JsonVisitor.h"
+#include "libjwt/Jwt.h"
+
+namespace jwt {
+
+// Counts tokens per issuer in fixed-width time buckets, both by when they
+// were issued ("iat") and by when they expire ("exp").  Buckets start at
+// multiples of their width since the epoch, so a day runs midnight to
+// midnight UTC.
+//
+// Histograms built on separate threads can be merged.
+class TimeHistogram
+{
+public:
+  static constexpr std::int64_t kMinute = 60;
+  static constexpr std::int64_t kHour = 60 * kMinute;
+  static constexpr std::int64_t kDay = 24 * kHour;
+
+  explicit TimeHistogram(std::int64_t bucket_seconds = kHour);
+
+  void add(const Jwt& token);
+  void merge(const TimeHistogram& other);
+
+  // One row per issuer and bucket that saw any token, ordered by time and
+  // then issuer, e.g.
+  //
+  //   {"time": "2026-10-18T10:00:00Z", "iss": "...", "issued": 3, "expiring": 0}
+  //
+  // Tokens without an issuer are listed with a null "iss".
+  ordered_json to_json() const;
+
+private:
+  struct Counts
+  {
+    std::uint64_t issued {0};
+    std::uint64_t expiring {0};
+  };
+
+  using Buckets = std::unordered_map<std::int64_t, Counts>;
+
+  std::int64_t bucket_of(std::int64_t seconds) const;
+
+  std::int64_t bucket_seconds_;
+
+  // Keyed by issuer, with the empty string standing in for none.
+  std::unordered_map<std::string, Buckets> issuers_;
+
+  // Tokens with neither "iat" nor "exp".
+  std::uint64_t untimed_ {0};
+};
+
+// Formats seconds since the epoch as an ISO 8601 UTC timestamp, e.g.
+// "2026-10-18T10:00:00Z".
+std::string format_utc(std::int64_t seconds);
+
+} // namespace jwt
+
+#endif // JWT_LIB_TIMEHISTOGRAM_H
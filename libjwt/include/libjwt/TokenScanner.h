@@ -0,0 +1,58 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_TOKENSCANNER_H
+#define JWT_LIB_TOKENSCANNER_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace jwt {
+
+// Finds JWT-shaped runs in arbitrary text, such as access logs.
+//
+// A run starts with "eyJ" (a base64url-encoded '{"') at a word boundary and
+// consists of three or five base64url segments joined by '.', i.e. a JWS or
+// JWE compact serialization.  Runs are only matched by shape; they still need
+// to go through Jwt::parse.
+class TokenScanner
+{
+public:
+  // Receives each token along with its byte offset from the start of input.
+  using Callback = std::function<void(std::string_view token, std::uint64_t offset)>;
+
+  // Scans the next part of a stream, returning how many bytes of `buffer`
+  // were consumed.  Unconsumed bytes may hold the start of a token; they must
+  // be passed again, followed by more input, on the next call.  Set
+  // `end_of_input` on the last call so that everything is consumed.
+  std::size_t scan(std::string_view buffer, bool end_of_input, const Callback& on_token);
+
+private:
+  std::uint64_t offset_ {0};
+  char previous_ {'\n'};
+};
+
+// Scans a complete text for tokens.
+void find_tokens(std::string_view text, const TokenScanner::Callback& on_token);
+
+} // namespace jwt
+
+#endif // JWT_LIB_TOKENSCANNER_H
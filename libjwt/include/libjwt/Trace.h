@@ -0,0 +1,113 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_TRACE_H
+#define JWT_LIB_TRACE_H
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace jwt {
+
+// Records timed spans from any number of threads and writes them out in the
+// Chrome trace-event format, which chrome://tracing and Perfetto can open.
+//
+// Each thread appends to its own ring buffer without locking.  A buffer grows
+// as spans are recorded up to `events_per_thread`, after which its oldest
+// spans are overwritten.  Buffers belong to the Trace, so threads may exit
+// before it is written.
+class Trace
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit Trace(std::size_t events_per_thread = 1 << 18);
+  ~Trace();
+
+  Trace(const Trace&) = delete;
+  Trace& operator=(const Trace&) = delete;
+
+  // Records a span on the calling thread.  `name` must outlive the Trace;
+  // in practice, it is a string literal.
+  void record(const char* name, Clock::time_point start, Clock::time_point end);
+
+  // Labels the calling thread in the output, e.g. "decoder 2".
+  void set_thread_name(std::string name);
+
+  // Writes every recorded span as a JSON document.  Only call this once the
+  // recording threads are done.
+  void write(std::ostream& os) const;
+
+private:
+  struct Event
+  {
+    const char* name;
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+  };
+
+  struct ThreadBuffer
+  {
+    std::string name;
+    std::vector<Event> events;
+    std::uint64_t recorded {0};
+  };
+
+  ThreadBuffer& thread_buffer();
+
+  const std::uint64_t id_;
+  const std::size_t events_per_thread_;
+  const Clock::time_point origin_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> threads_;
+};
+
+// Installs the process-wide Trace that ScopedPhase and ScopedSpan record
+// into, or null (the default) to record nothing.
+void set_trace(Trace* trace);
+Trace* current_trace();
+
+// Records a span into the installed Trace, if there is one, without touching
+// Stats.  Use this for anything that is not a Phase, e.g. a whole token or a
+// wait on a queue.
+class ScopedSpan
+{
+public:
+  explicit ScopedSpan(const char* name);
+  ~ScopedSpan();
+
+  ScopedSpan(const ScopedSpan&) = delete;
+  ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+  Trace* trace_;
+  const char* name_;
+  Trace::Clock::time_point start_;
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_TRACE_H
@@ -34,4 +34,12 @@ constexpr const char* newline = "\n";
 
 #endif
 
+#if defined(__linux__)
+#define JWT_OS_LINUX 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JWT_HAVE_SSE2 1
+#endif
+
 #endif // JWT_LIB_CONFIG_H
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/Stats.h"
+
+#if defined(JWT_COUNT_ALLOCATIONS)
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Per thread, so that a phase only sees its own allocations.
+thread_local std::uint64_t t_allocation_count = 0;
+thread_local std::uint64_t t_allocated_bytes = 0;
+
+void* counted_allocate(std::size_t size)
+{
+  ++t_allocation_count;
+  t_allocated_bytes += size;
+
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+  {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size)
+{
+  return counted_allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return counted_allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+#endif // JWT_COUNT_ALLOCATIONS
+
+namespace jwt {
+
+AllocationCount thread_allocations()
+{
+#if defined(JWT_COUNT_ALLOCATIONS)
+  return AllocationCount{t_allocation_count, t_allocated_bytes};
+#else
+  return AllocationCount{};
+#endif
+}
+
+} // namespace jwt
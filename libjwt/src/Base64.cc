@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <exception>
 #include <stdexcept>
 #include <string>
@@ -37,7 +38,7 @@ namespace {
 class Base64 {
  public:
 
-  static std::string Encode(const std::string data) {
+  static std::string Encode(std::string_view data) {
     static constexpr std::array<char, 64> sEncodingTable = {
       'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H',
       'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
@@ -55,7 +56,7 @@ class Base64 {
     size_t i;
     char *p = const_cast<char*>(ret.c_str());
 
-    for (i = 0; i < in_len - 2; i += 3) {
+    for (i = 0; i + 2 < in_len; i += 3) {
       *p++ = sEncodingTable[(data[i] >> 2) & 0x3F];
       *p++ = sEncodingTable[((data[i] & 0x3) << 4) | ((int) (data[i + 1] & 0xF0) >> 4)];
       *p++ = sEncodingTable[((data[i + 1] & 0xF) << 2) | ((int) (data[i + 2] & 0xC0) >> 6)];
@@ -124,34 +125,115 @@ class Base64 {
 
 }; // class Base64
 
+constexpr unsigned char kInvalid = 0xFF;
+
+constexpr std::array<unsigned char, 256> make_urlsafe_decoding_table()
+{
+  std::array<unsigned char, 256> table {};
+  for (auto& value : table) value = kInvalid;
+  for (int i = 0; i < 26; ++i) table['A' + i] = static_cast<unsigned char>(i);
+  for (int i = 0; i < 26; ++i) table['a' + i] = static_cast<unsigned char>(26 + i);
+  for (int i = 0; i < 10; ++i) table['0' + i] = static_cast<unsigned char>(52 + i);
+  table['-'] = table['+'] = 62;
+  table['_'] = table['/'] = 63;
+  return table;
+}
+
+constexpr std::array<unsigned char, 256> kUrlsafeDecodingTable = make_urlsafe_decoding_table();
+
 } // anonymous namespace
 
-std::string base64_urlsafe_decode(const std::string& data)
+bool base64_urlsafe_decode(std::string_view data, std::string& out, std::size_t& error_position)
 {
-  std::string copy{data};
-  std::replace(copy.begin(), copy.end(), '-', '+');
-  std::replace(copy.begin(), copy.end(), '_', '/');
-  switch (copy.size() % 4)
+  auto in_len = data.size();
+  if (in_len % 4 == 0 && in_len > 0 && data[in_len - 1] == '=')
+  {
+    --in_len;
+    if (data[in_len - 1] == '=')
+    {
+      --in_len;
+    }
+  }
+
+  if (in_len % 4 == 1)
   {
-    case 0:
-      // no padding needed
-      break;
-    case 1:
-      // illegal encoding
-      throw std::runtime_error{"illegal base64 argument"};
-      break;
-    case 2:
-      copy += "==";
-      break;
-    case 3:
-      copy += "=";
-      break;
-    default:
-      throw std::runtime_error{"impossible"};
-      break;
+    // A single leftover character can't encode a whole byte.
+    error_position = in_len - 1;
+    return false;
   }
 
-  return base64_decode(copy);
+  auto remainder = in_len % 4;
+  out.resize(in_len / 4 * 3 + (remainder > 0 ? remainder - 1 : 0));
+
+  auto* in = reinterpret_cast<const unsigned char*>(data.data());
+  auto* p = &out[0];
+
+  std::size_t i = 0;
+  for (; i + 4 <= in_len; i += 4)
+  {
+    auto a = kUrlsafeDecodingTable[in[i]];
+    auto b = kUrlsafeDecodingTable[in[i + 1]];
+    auto c = kUrlsafeDecodingTable[in[i + 2]];
+    auto d = kUrlsafeDecodingTable[in[i + 3]];
+
+    // Valid values fit in six bits, so one test catches any invalid byte.
+    if ((a | b | c | d) == kInvalid)
+    {
+      for (error_position = i; kUrlsafeDecodingTable[in[error_position]] != kInvalid; ++error_position) {}
+      return false;
+    }
+
+    std::uint32_t triple = (a << 18) | (b << 12) | (c << 6) | d;
+    *p++ = static_cast<char>((triple >> 16) & 0xFF);
+    *p++ = static_cast<char>((triple >> 8) & 0xFF);
+    *p++ = static_cast<char>(triple & 0xFF);
+  }
+
+  if (remainder > 0)
+  {
+    std::uint32_t triple = 0;
+    for (std::size_t j = 0; j < remainder; ++j)
+    {
+      auto value = kUrlsafeDecodingTable[in[i + j]];
+      if (value == kInvalid)
+      {
+        error_position = i + j;
+        return false;
+      }
+      triple |= static_cast<std::uint32_t>(value) << (18 - 6 * j);
+    }
+
+    *p++ = static_cast<char>((triple >> 16) & 0xFF);
+    if (remainder == 3)
+    {
+      *p++ = static_cast<char>((triple >> 8) & 0xFF);
+    }
+  }
+
+  return true;
+}
+
+std::string base64_urlsafe_encode(std::string_view data)
+{
+  auto encoded = Base64::Encode(data);
+  while (!encoded.empty() && encoded.back() == '=')
+  {
+    encoded.pop_back();
+  }
+  std::replace(encoded.begin(), encoded.end(), '+', '-');
+  std::replace(encoded.begin(), encoded.end(), '/', '_');
+  return encoded;
+}
+
+std::string base64_urlsafe_decode(std::string_view data)
+{
+  std::string result;
+  std::size_t error_position;
+  if (!base64_urlsafe_decode(data, result, error_position))
+  {
+    throw std::runtime_error{"illegal base64 argument"};
+  }
+  return result;
 }
 
 std::string base64_decode(const std::string& encoded_string)
@@ -20,11 +20,21 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace jwt {
 
-std::string base64_urlsafe_decode(const std::string& data);
+// Decodes base64url, with or without padding, into `out`.  The standard
+// alphabet's '+' and '/' are accepted too.  On failure, returns false and
+// sets `error_position` to the offset of the first offending byte.
+bool base64_urlsafe_decode(std::string_view data, std::string& out, std::size_t& error_position);
+
+std::string base64_urlsafe_decode(std::string_view data);
+
+// Encodes `data` as unpadded base64url, as used in compact serializations.
+std::string base64_urlsafe_encode(std::string_view data);
 std::string base64_decode(const std::string& data);
 
 } // namespace jwt
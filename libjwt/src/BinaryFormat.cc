@@ -0,0 +1,150 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/BinaryFormat.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace jwt {
+
+namespace {
+
+void append_big_endian(std::string& out, std::uint64_t value, std::size_t bytes)
+{
+  while (bytes-- > 0)
+  {
+    out += static_cast<char>(value >> (8 * bytes));
+  }
+}
+
+// The head of a map of `size` entries; there are never more than five.
+void append_map(std::string& out, std::size_t size, BinaryFormat format)
+{
+  out += static_cast<char>((format == BinaryFormat::Cbor ? 0xA0 : 0x80) | size);
+}
+
+// A UTF-8 string, in the shortest form either format allows, as nlohmann
+// would encode it.
+void append_string(std::string& out, std::string_view text, BinaryFormat format)
+{
+  auto size = static_cast<std::uint64_t>(text.size());
+  if (format == BinaryFormat::Cbor)
+  {
+    if (size < 24)
+    {
+      out += static_cast<char>(0x60 | size);
+    }
+    else if (size <= 0xFF)
+    {
+      out += static_cast<char>(0x78);
+      append_big_endian(out, size, 1);
+    }
+    else if (size <= 0xFFFF)
+    {
+      out += static_cast<char>(0x79);
+      append_big_endian(out, size, 2);
+    }
+    else if (size <= 0xFFFFFFFF)
+    {
+      out += static_cast<char>(0x7A);
+      append_big_endian(out, size, 4);
+    }
+    else
+    {
+      out += static_cast<char>(0x7B);
+      append_big_endian(out, size, 8);
+    }
+  }
+  else
+  {
+    if (size < 32)
+    {
+      out += static_cast<char>(0xA0 | size);
+    }
+    else if (size <= 0xFF)
+    {
+      out += static_cast<char>(0xD9);
+      append_big_endian(out, size, 1);
+    }
+    else if (size <= 0xFFFF)
+    {
+      out += static_cast<char>(0xDA);
+      append_big_endian(out, size, 2);
+    }
+    else
+    {
+      // MessagePack strings cannot be longer, and neither can a frame.
+      out += static_cast<char>(0xDB);
+      append_big_endian(out, size, 4);
+    }
+  }
+  out.append(text.data(), text.size());
+}
+
+void append_json(std::string& out, const ordered_json& json, BinaryFormat format)
+{
+  if (format == BinaryFormat::Cbor)
+  {
+    ordered_json::to_cbor(json, out);
+  }
+  else
+  {
+    ordered_json::to_msgpack(json, out);
+  }
+}
+
+} // anonymous namespace
+
+void append_frame(std::string& out, const Jwt& token, BinaryFormat format)
+{
+  auto start = out.size();
+  out.append(4, '\0');
+
+  bool encrypted = !token.ciphertext().empty();
+  append_map(out, encrypted ? 5 : 3, format);
+
+  append_string(out, "header", format);
+  append_json(out, token.header(), format);
+
+  if (encrypted)
+  {
+    append_string(out, "encrypted_key", format);
+    append_string(out, token.encrypted_key(), format);
+    append_string(out, "initialization_vector", format);
+    append_string(out, token.initialization_vector(), format);
+    append_string(out, "ciphertext", format);
+    append_string(out, token.ciphertext(), format);
+    append_string(out, "authentication_tag", format);
+    append_string(out, token.authentication_tag(), format);
+  }
+  else
+  {
+    append_string(out, "payload", format);
+    append_json(out, token.payload(), format);
+    append_string(out, "signature", format);
+    append_string(out, token.signature(), format);
+  }
+
+  auto size = static_cast<std::uint32_t>(out.size() - start - 4);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    out[start + i] = static_cast<char>(size >> (8 * (3 - i)));
+  }
+}
+
+} // namespace jwt
@@ -0,0 +1,600 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/ClaimIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "libjwt/InputError.h"
+
+#include "Claims.h"
+#include "Sections.h"
+
+namespace jwt {
+
+namespace {
+
+constexpr char kMagic[8] = {'J', 'W', 'T', 'I', 'N', 'D', 'E', 'X'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr std::size_t kFileHeaderSize = 16;
+
+// Strings are numbered from 1 in 32 bits.
+constexpr std::size_t kMaxStrings = std::numeric_limits<std::uint32_t>::max();
+
+// Entries are stored as they are in memory, and read back with load().
+static_assert(sizeof(IndexEntry) == 40 && std::is_trivially_copyable<IndexEntry>::value, "IndexEntry must have no padding");
+
+auto key_of(const IndexEntry& entry)
+{
+  return std::tie(entry.iss, entry.sub, entry.exp, entry.source, entry.offset);
+}
+
+// The strings of a table of `count` strings, with `count` + 1 offsets.
+std::string_view slice(const char* offsets, const char* chars, std::size_t chars_size, std::size_t i)
+{
+  auto begin = load<std::uint64_t>(offsets, i);
+  auto end = load<std::uint64_t>(offsets, i + 1);
+  if (begin > end || end > chars_size)
+  {
+    throw InputError{"Index is truncated or damaged"};
+  }
+  return std::string_view{chars + begin, static_cast<std::size_t>(end - begin)};
+}
+
+void put_strings(std::string& out, const std::vector<std::string_view>& strings)
+{
+  std::vector<std::uint64_t> offsets {0};
+  std::string chars;
+  for (auto text : strings)
+  {
+    chars += text;
+    offsets.push_back(chars.size());
+  }
+  put_section(out, offsets);
+  put_section(out, chars.data(), chars.size());
+}
+
+} // anonymous namespace
+
+ClaimIndexBuilder::ClaimIndexBuilder(std::string run_path, std::size_t run_size)
+  : run_path_(std::move(run_path))
+  , run_size_(std::max<std::size_t>(run_size, 1))
+{}
+
+ClaimIndexBuilder::~ClaimIndexBuilder()
+{
+  if (run_file_.is_open())
+  {
+    run_file_.close();
+    std::remove(run_path_.c_str());
+  }
+}
+
+void ClaimIndexBuilder::add(const Jwt& token, std::uint32_t source, std::uint64_t offset, std::uint64_t line, std::uint32_t length)
+{
+  const auto& payload = token.payload();
+
+  IndexEntry entry {};
+  if (auto* iss = find_claim(payload, "iss"))
+  {
+    entry.iss = intern(claim_text(*iss, scratch_));
+  }
+  if (auto* sub = find_claim(payload, "sub"))
+  {
+    entry.sub = intern(claim_text(*sub, scratch_));
+  }
+  if (!get_seconds(payload, "exp", entry.exp))
+  {
+    entry.exp = kNoExpiry;
+  }
+  entry.offset = offset;
+  entry.line = line;
+  entry.source = source;
+  entry.length = length;
+
+  entries_.push_back(entry);
+  if (!run_path_.empty() && entries_.size() >= run_size_)
+  {
+    spill();
+  }
+}
+
+// Sorts the entries collected since the last run like the index will be.
+// Ids are this builder's own, so they are compared by their strings, which
+// keeps the order once they are renumbered.
+void ClaimIndexBuilder::sort_entries()
+{
+  auto key = [this](const IndexEntry& entry) {
+    auto text = [this](std::uint32_t id) { return id != 0 ? std::string_view{*strings_[id - 1]} : std::string_view{}; };
+    return std::make_tuple(entry.iss != 0, text(entry.iss), entry.sub != 0, text(entry.sub), entry.exp, entry.source, entry.offset);
+  };
+  std::sort(entries_.begin(), entries_.end(), [&key](const IndexEntry& a, const IndexEntry& b) { return key(a) < key(b); });
+}
+
+void ClaimIndexBuilder::spill()
+{
+  if (!run_file_.is_open())
+  {
+    run_file_.open(run_path_, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!run_file_)
+    {
+      throw std::runtime_error("Could not create " + run_path_);
+    }
+  }
+
+  sort_entries();
+  run_file_.seekp(0, std::ios::end);
+  run_file_.write(reinterpret_cast<const char*>(entries_.data()), static_cast<std::streamsize>(entries_.size() * sizeof(IndexEntry)));
+  if (!run_file_)
+  {
+    throw std::runtime_error("Could not write to " + run_path_);
+  }
+
+  runs_.push_back(Run{spilled_, entries_.size()});
+  spilled_ += entries_.size();
+  entries_.clear();
+}
+
+// Reads one run in order, from the run file a block at a time or straight
+// from memory, renumbering strings as it goes.
+class ClaimIndexBuilder::Cursor
+{
+public:
+  static constexpr std::size_t kBlockSize = 4096;
+
+  Cursor(ClaimIndexBuilder& builder, const std::vector<std::uint32_t>& rank, Run run)
+    : builder_(builder)
+    , rank_(rank)
+    , next_(run.begin)
+    , end_(run.begin + run.size)
+  {
+    refill();
+  }
+
+  Cursor(ClaimIndexBuilder& builder, const std::vector<std::uint32_t>& rank, const std::vector<IndexEntry>& entries)
+    : builder_(builder)
+    , rank_(rank)
+    , at_(entries.data())
+    , last_(entries.data() + entries.size())
+  {
+    load();
+  }
+
+  bool done() const { return done_; }
+  const IndexEntry& current() const { return current_; }
+
+  void advance()
+  {
+    ++at_;
+    if (at_ == last_ && next_ < end_)
+    {
+      refill();
+    }
+    else
+    {
+      load();
+    }
+  }
+
+private:
+  void refill()
+  {
+    auto count = static_cast<std::size_t>(std::min<std::uint64_t>(kBlockSize, end_ - next_));
+    block_.resize(count);
+    auto& file = builder_.run_file_;
+    file.seekg(static_cast<std::streamoff>(next_ * sizeof(IndexEntry)));
+    file.read(reinterpret_cast<char*>(block_.data()), static_cast<std::streamsize>(count * sizeof(IndexEntry)));
+    if (!file)
+    {
+      throw std::runtime_error("Could not read " + builder_.run_path_);
+    }
+    next_ += count;
+    at_ = block_.data();
+    last_ = block_.data() + block_.size();
+    load();
+  }
+
+  void load()
+  {
+    done_ = at_ == last_;
+    if (!done_)
+    {
+      current_ = *at_;
+      current_.iss = rank_[current_.iss];
+      current_.sub = rank_[current_.sub];
+    }
+  }
+
+  ClaimIndexBuilder& builder_;
+  const std::vector<std::uint32_t>& rank_;
+  std::uint64_t next_ {0};
+  std::uint64_t end_ {0};
+  std::vector<IndexEntry> block_;
+  const IndexEntry* at_ {nullptr};
+  const IndexEntry* last_ {nullptr};
+  IndexEntry current_ {};
+  bool done_ {true};
+};
+
+void ClaimIndexBuilder::write(std::ostream& os, const std::vector<ClaimIndexBuilder*>& builders, const std::vector<std::string>& paths)
+{
+  // Number the strings of all builders together in sorted order, so that
+  // ids compare like them; rank[b][id] is the number for builder b's id.
+  struct Named
+  {
+    std::string_view text;
+    std::size_t builder;
+    std::uint32_t id;
+  };
+  std::vector<Named> named;
+  for (std::size_t b = 0; b < builders.size(); ++b)
+  {
+    const auto& strings = builders[b]->strings_;
+    for (std::size_t i = 0; i < strings.size(); ++i)
+    {
+      named.push_back(Named{*strings[i], b, static_cast<std::uint32_t>(i + 1)});
+    }
+  }
+  std::sort(named.begin(), named.end(), [](const Named& a, const Named& b) { return a.text < b.text; });
+
+  std::vector<std::vector<std::uint32_t>> rank(builders.size());
+  for (std::size_t b = 0; b < builders.size(); ++b)
+  {
+    rank[b].assign(builders[b]->strings_.size() + 1, 0);
+  }
+  std::vector<std::string_view> sorted;
+  for (const auto& name : named)
+  {
+    if (sorted.empty() || sorted.back() != name.text)
+    {
+      if (sorted.size() == kMaxStrings)
+      {
+        throw std::length_error{"Too many distinct iss and sub claims for an index"};
+      }
+      sorted.push_back(name.text);
+    }
+    rank[name.builder][name.id] = static_cast<std::uint32_t>(sorted.size());
+  }
+
+  // Every run is sorted, so the index is a merge of them all.
+  std::size_t runs = 0;
+  for (const auto* builder : builders)
+  {
+    runs += builder->runs_.size() + 1;
+  }
+
+  std::vector<Cursor> cursors;
+  cursors.reserve(runs);
+  std::uint64_t total = 0;
+  for (std::size_t b = 0; b < builders.size(); ++b)
+  {
+    auto& builder = *builders[b];
+    builder.sort_entries();
+    total += builder.size();
+    if (builder.run_file_.is_open())
+    {
+      builder.run_file_.flush();
+    }
+
+    for (const auto& run : builder.runs_)
+    {
+      cursors.emplace_back(builder, rank[b], run);
+    }
+    cursors.emplace_back(builder, rank[b], builder.entries_);
+  }
+
+  auto later = [&cursors](std::size_t a, std::size_t b) { return key_of(cursors[b].current()) < key_of(cursors[a].current()); };
+  std::vector<std::size_t> heap;
+  for (std::size_t i = 0; i < cursors.size(); ++i)
+  {
+    if (!cursors[i].done())
+    {
+      heap.push_back(i);
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), later);
+
+  std::string head(kMagic, sizeof(kMagic));
+  put(head, kVersion);
+  put(head, kByteOrder);
+  put_strings(head, sorted);
+  put_strings(head, std::vector<std::string_view>(paths.begin(), paths.end()));
+  put<std::uint64_t>(head, total * sizeof(IndexEntry));
+  os.write(head.data(), static_cast<std::streamsize>(head.size()));
+
+  std::vector<IndexEntry> block;
+  block.reserve(Cursor::kBlockSize);
+  auto flush = [&os, &block] {
+    os.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(IndexEntry)));
+    block.clear();
+  };
+  while (!heap.empty())
+  {
+    std::pop_heap(heap.begin(), heap.end(), later);
+    auto& cursor = cursors[heap.back()];
+    block.push_back(cursor.current());
+    if (block.size() == Cursor::kBlockSize)
+    {
+      flush();
+    }
+
+    cursor.advance();
+    if (cursor.done())
+    {
+      heap.pop_back();
+    }
+    else
+    {
+      std::push_heap(heap.begin(), heap.end(), later);
+    }
+  }
+  flush();
+}
+
+std::uint32_t ClaimIndexBuilder::intern(std::string_view text)
+{
+  // Reusing one key keeps lookups of strings already seen from allocating.
+  key_.assign(text.data(), text.size());
+  auto it = ids_.find(key_);
+  if (it == ids_.end())
+  {
+    if (strings_.size() == kMaxStrings)
+    {
+      throw std::length_error{"Too many distinct iss and sub claims for an index"};
+    }
+    it = ids_.emplace(key_, static_cast<std::uint32_t>(strings_.size() + 1)).first;
+    strings_.push_back(&it->first);
+  }
+  return it->second;
+}
+
+ClaimIndex::ClaimIndex(std::string_view data)
+{
+  if (data.size() < kFileHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0)
+  {
+    throw InputError{"Not an index"};
+  }
+  if (load<std::uint32_t>(data.data() + sizeof(kMagic), 0) != kVersion)
+  {
+    throw InputError{"Unsupported index version"};
+  }
+  if (load<std::uint32_t>(data.data() + sizeof(kMagic), 1) != kByteOrder)
+  {
+    throw InputError{"Index was written with a different byte order"};
+  }
+
+  // Only the layout is checked here, so that opening a big index stays
+  // cheap; strings are checked as they are looked up.
+  SectionReader reader{data.substr(kFileHeaderSize), "Index"};
+  auto string_offsets = reader.section(sizeof(std::uint64_t));
+  auto string_chars = reader.section(1);
+  auto source_offsets = reader.section(sizeof(std::uint64_t));
+  auto source_chars = reader.section(1);
+  auto entries = reader.section(sizeof(IndexEntry));
+  if (!reader.done() || string_offsets.empty() || source_offsets.empty())
+  {
+    reader.fail();
+  }
+
+  strings_ = string_offsets.size() / sizeof(std::uint64_t) - 1;
+  string_offsets_ = string_offsets.data();
+  string_chars_ = string_chars.data();
+  string_chars_size_ = string_chars.size();
+
+  sources_ = source_offsets.size() / sizeof(std::uint64_t) - 1;
+  source_offsets_ = source_offsets.data();
+  source_chars_ = source_chars.data();
+  source_chars_size_ = source_chars.size();
+
+  entries_ = entries.size() / sizeof(IndexEntry);
+  entry_data_ = entries.data();
+}
+
+std::string_view ClaimIndex::source(std::uint32_t source) const
+{
+  if (source >= sources_)
+  {
+    throw InputError{"Index is truncated or damaged"};
+  }
+  return slice(source_offsets_, source_chars_, source_chars_size_, source);
+}
+
+std::string_view ClaimIndex::string(std::uint32_t id) const
+{
+  if (id == 0)
+  {
+    return {};
+  }
+  if (id > strings_)
+  {
+    throw InputError{"Index is truncated or damaged"};
+  }
+  return slice(string_offsets_, string_chars_, string_chars_size_, id - 1);
+}
+
+void ClaimIndex::query(const std::vector<ClaimCondition>& conditions, const EntryCallback& on_entry) const
+{
+  std::uint32_t iss = 0;
+  std::uint32_t sub = 0;
+  bool by_iss = false;
+  bool by_sub = false;
+  auto lo = kNoExpiry;
+  auto hi = std::numeric_limits<std::int64_t>::max();
+
+  bool none = false;
+  for (const auto& condition : conditions)
+  {
+    using Op = ClaimCondition::Op;
+
+    if ((condition.column == ClaimColumn::Iss || condition.column == ClaimColumn::Sub) && condition.op == Op::Equal)
+    {
+      auto& id = condition.column == ClaimColumn::Iss ? iss : sub;
+      auto& known = condition.column == ClaimColumn::Iss ? by_iss : by_sub;
+      std::uint32_t found;
+      if (!find_string(condition.text, found) || (known && found != id))
+      {
+        none = true;
+      }
+      id = found;
+      known = true;
+      continue;
+    }
+
+    if (condition.column != ClaimColumn::Exp || condition.op == Op::NotEqual)
+    {
+      throw InputError{"An index can only be searched by iss=, sub= and comparisons of exp"};
+    }
+
+    // Turn every comparison into an inclusive range without missing values.
+    auto bound = condition.number;
+    lo = std::max(lo, kNoExpiry + 1);
+    switch (condition.op)
+    {
+      case Op::Equal: lo = std::max(lo, bound); hi = std::min(hi, bound); break;
+      case Op::Less:
+        if (bound == kNoExpiry)
+        {
+          none = true;
+        }
+        else
+        {
+          hi = std::min(hi, bound - 1);
+        }
+        break;
+      case Op::LessEqual: hi = std::min(hi, bound); break;
+      case Op::Greater:
+        if (bound == std::numeric_limits<std::int64_t>::max())
+        {
+          none = true;
+        }
+        else
+        {
+          lo = std::max(lo, bound + 1);
+        }
+        break;
+      default: lo = std::max(lo, bound); break;
+    }
+  }
+  if (none || lo > hi)
+  {
+    return;
+  }
+
+  auto scan = [&](std::size_t first, std::size_t last) {
+    for (auto i = first; i < last; ++i)
+    {
+      auto e = entry(i);
+      if (lo <= e.exp && e.exp <= hi)
+      {
+        on_entry(e);
+      }
+    }
+  };
+
+  // Looks within the entries [first, last) of one issuer.
+  auto search_issuer = [&](std::size_t first, std::size_t last) {
+    if (!by_sub)
+    {
+      scan(first, last);
+      return;
+    }
+    auto begin = partition_point(first, last, [&](const IndexEntry& e) { return e.sub < sub || (e.sub == sub && e.exp < lo); });
+    auto end = partition_point(begin, last, [&](const IndexEntry& e) { return e.sub == sub && e.exp <= hi; });
+    for (auto i = begin; i < end; ++i)
+    {
+      on_entry(entry(i));
+    }
+  };
+
+  if (by_iss)
+  {
+    auto first = partition_point(0, entries_, [&](const IndexEntry& e) { return e.iss < iss; });
+    auto last = partition_point(first, entries_, [&](const IndexEntry& e) { return e.iss == iss; });
+    search_issuer(first, last);
+  }
+  else if (by_sub)
+  {
+    for (std::size_t first = 0; first < entries_;)
+    {
+      auto issuer = entry(first).iss;
+      auto last = partition_point(first, entries_, [&](const IndexEntry& e) { return e.iss == issuer; });
+      search_issuer(first, last);
+      first = last;
+    }
+  }
+  else
+  {
+    scan(0, entries_);
+  }
+}
+
+IndexEntry ClaimIndex::entry(std::size_t i) const
+{
+  return load<IndexEntry>(entry_data_, i);
+}
+
+bool ClaimIndex::find_string(std::string_view text, std::uint32_t& id) const
+{
+  std::size_t first = 0;
+  std::size_t count = strings_;
+  while (count > 0)
+  {
+    auto half = count / 2;
+    if (string(static_cast<std::uint32_t>(first + half + 1)) < text)
+    {
+      first += half + 1;
+      count -= half + 1;
+    }
+    else
+    {
+      count = half;
+    }
+  }
+
+  id = static_cast<std::uint32_t>(first + 1);
+  return first < strings_ && string(id) == text;
+}
+
+template <typename Before>
+std::size_t ClaimIndex::partition_point(std::size_t first, std::size_t last, Before&& before) const
+{
+  auto count = last - first;
+  while (count > 0)
+  {
+    auto half = count / 2;
+    if (before(entry(first + half)))
+    {
+      first += half + 1;
+      count -= half + 1;
+    }
+    else
+    {
+      count = half;
+    }
+  }
+  return first;
+}
+
+} // namespace jwt
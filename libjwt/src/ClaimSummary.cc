@@ -0,0 +1,229 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/ClaimSummary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "libjwt/Hash.h"
+
+#include "Claims.h"
+
+namespace jwt {
+
+namespace {
+
+void count_claim(const ordered_json& object, const char* name, std::unordered_map<std::string, std::uint64_t>& counts)
+{
+  auto* value = find_claim(object, name);
+  if (value == nullptr)
+  {
+    return;
+  }
+
+  // Look up by the claim's own string, so that only new values are copied.
+  std::string scratch;
+  const auto& key = value->is_string() ? value->get_ref<const std::string&>() : (scratch = value->dump());
+
+  auto it = counts.find(key);
+  if (it != counts.end())
+  {
+    ++it->second;
+  }
+  else
+  {
+    counts.emplace(key, 1);
+  }
+}
+
+void add_to_sketch(const ordered_json& object, const char* name, HyperLogLog& sketch)
+{
+  if (auto* value = find_claim(object, name))
+  {
+    std::string scratch;
+    sketch.add(murmur3_128(claim_text(*value, scratch)).low);
+  }
+}
+
+ordered_json counts_to_json(const std::unordered_map<std::string, std::uint64_t>& counts)
+{
+  std::vector<std::pair<std::string, std::uint64_t>> sorted{counts.begin(), counts.end()};
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+
+  auto json = ordered_json::object();
+  for (auto& [value, count] : sorted)
+  {
+    json[value] = count;
+  }
+  return json;
+}
+
+ordered_json top_to_json(const TopK& top, std::size_t k)
+{
+  auto json = ordered_json::array();
+  for (auto& entry : top.top(k))
+  {
+    ordered_json item;
+    item["value"] = entry.value;
+    item["count"] = entry.count;
+    item["error"] = entry.error;
+    json.push_back(std::move(item));
+  }
+  return json;
+}
+
+void merge_counts(std::unordered_map<std::string, std::uint64_t>& into, const std::unordered_map<std::string, std::uint64_t>& from)
+{
+  for (auto& [value, count] : from)
+  {
+    into[value] += count;
+  }
+}
+
+} // anonymous namespace
+
+ClaimSummary::ClaimSummary()
+  : top_subjects_(kTopKCapacity)
+  , top_audiences_(kTopKCapacity)
+{}
+
+void ClaimSummary::add(const Jwt& token)
+{
+  ++tokens_;
+
+  const auto& header = token.header();
+  count_claim(header, "alg", algorithms_);
+  count_claim(header, "kid", key_ids_);
+
+  if (!token.ciphertext().empty())
+  {
+    // A JWE's claims are in its ciphertext.
+    ++encrypted_;
+    return;
+  }
+
+  const auto& payload = token.payload();
+  count_claim(payload, "iss", issuers_);
+  add_to_sketch(payload, "sub", subjects_);
+  add_to_sketch(payload, "jti", token_ids_);
+
+  std::string scratch;
+  if (auto* subject = find_claim(payload, "sub"))
+  {
+    top_subjects_.add(claim_text(*subject, scratch));
+  }
+
+  // "aud" may be a single audience or a list of them.
+  if (auto* audience = find_claim(payload, "aud"))
+  {
+    if (audience->is_array())
+    {
+      for (auto& item : *audience)
+      {
+        top_audiences_.add(claim_text(item, scratch));
+      }
+    }
+    else
+    {
+      top_audiences_.add(claim_text(*audience, scratch));
+    }
+  }
+
+  std::int64_t issued_at;
+  std::int64_t expires_at;
+  if (!get_seconds(payload, "iat", issued_at) || !get_seconds(payload, "exp", expires_at))
+  {
+    ++missing_lifetimes_;
+  }
+  else if (expires_at < issued_at)
+  {
+    ++negative_lifetimes_;
+  }
+  else
+  {
+    // Subtracting as signed could overflow for far-apart times.
+    lifetimes_.add(static_cast<std::uint64_t>(expires_at) - static_cast<std::uint64_t>(issued_at));
+  }
+}
+
+void ClaimSummary::merge(const ClaimSummary& other)
+{
+  tokens_ += other.tokens_;
+  encrypted_ += other.encrypted_;
+
+  merge_counts(algorithms_, other.algorithms_);
+  merge_counts(key_ids_, other.key_ids_);
+  merge_counts(issuers_, other.issuers_);
+
+  subjects_.merge(other.subjects_);
+  token_ids_.merge(other.token_ids_);
+
+  top_subjects_.merge(other.top_subjects_);
+  top_audiences_.merge(other.top_audiences_);
+
+  lifetimes_.merge(other.lifetimes_);
+  negative_lifetimes_ += other.negative_lifetimes_;
+  missing_lifetimes_ += other.missing_lifetimes_;
+}
+
+ordered_json ClaimSummary::to_json() const
+{
+  ordered_json json;
+  json["tokens"] = tokens_;
+  json["encrypted"] = encrypted_;
+
+  json["alg"] = counts_to_json(algorithms_);
+  json["kid"] = counts_to_json(key_ids_);
+  json["iss"] = counts_to_json(issuers_);
+
+  json["distinct"]["sub"] = static_cast<std::uint64_t>(std::llround(subjects_.estimate()));
+  json["distinct"]["jti"] = static_cast<std::uint64_t>(std::llround(token_ids_.estimate()));
+
+  json["top"]["sub"] = top_to_json(top_subjects_, kTopK);
+  json["top"]["aud"] = top_to_json(top_audiences_, kTopK);
+
+  // Only buckets that saw a token, each as [min, max] seconds.
+  auto buckets = ordered_json::array();
+  for (std::size_t i = 0; i < Log2Histogram::kNumBuckets; ++i)
+  {
+    if (lifetimes_.count(i) == 0)
+    {
+      continue;
+    }
+
+    ordered_json bucket;
+    bucket["min"] = Log2Histogram::lower_bound(i);
+    bucket["max"] = i + 1 < Log2Histogram::kNumBuckets
+        ? Log2Histogram::lower_bound(i + 1) - 1
+        : std::numeric_limits<std::uint64_t>::max();
+    bucket["count"] = lifetimes_.count(i);
+    buckets.push_back(std::move(bucket));
+  }
+  json["lifetime"]["seconds"] = std::move(buckets);
+  json["lifetime"]["negative"] = negative_lifetimes_;
+  json["lifetime"]["missing"] = missing_lifetimes_;
+
+  return json;
+}
+
+} // namespace jwt
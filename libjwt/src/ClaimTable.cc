@@ -0,0 +1,607 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/ClaimTable.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "libjwt/InputError.h"
+
+#include "Claims.h"
+#include "Sections.h"
+
+namespace jwt {
+
+namespace {
+
+// Columns by index: strings first, then integers, then leftover JSON.
+constexpr const char* kNames[kClaimColumnCount] = {
+  "alg", "kid", "typ", "iss", "sub", "aud", "jti", "iat", "nbf", "exp", "other_header", "other_claims",
+};
+
+constexpr std::size_t kFirstInteger = 7;
+constexpr std::size_t kFirstText = 10;
+
+// The first three string columns come from the header.
+constexpr std::size_t kFirstPayload = 3;
+
+constexpr char kMagic[8] = {'J', 'W', 'T', 'C', 'L', 'A', 'I', 'M'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr std::size_t kFileHeaderSize = 16;
+
+// Marks a row without a value in an integer column.
+constexpr std::int64_t kMissing = std::numeric_limits<std::int64_t>::min();
+
+// Keeps offsets within a block in 32 bits, with room to spare.
+constexpr std::size_t kMaxBlockChars = std::size_t{1} << 30;
+
+std::size_t index_of(ClaimColumn column)
+{
+  return static_cast<std::size_t>(column);
+}
+
+[[noreturn]] void damaged()
+{
+  throw InputError{"Claim table is truncated or damaged"};
+}
+
+// Checks that `offsets` are `count` + 1 ascending offsets into `chars`.
+void check_offsets(std::string_view offsets, std::size_t count, std::string_view chars)
+{
+  if (offsets.size() != (count + 1) * sizeof(std::uint32_t) || load<std::uint32_t>(offsets.data(), 0) != 0)
+  {
+    damaged();
+  }
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (load<std::uint32_t>(offsets.data(), i + 1) < load<std::uint32_t>(offsets.data(), i))
+    {
+      damaged();
+    }
+  }
+  if (load<std::uint32_t>(offsets.data(), count) != chars.size())
+  {
+    damaged();
+  }
+}
+
+std::string_view slice(const char* offsets, const char* chars, std::size_t i)
+{
+  auto begin = load<std::uint32_t>(offsets, i);
+  auto end = load<std::uint32_t>(offsets, i + 1);
+  return std::string_view{chars + begin, end - begin};
+}
+
+bool fits_integer(const ordered_json& value)
+{
+  if (value.is_number_unsigned())
+  {
+    return value.get<std::uint64_t>() <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+  }
+  return value.is_number_integer() && value.get<std::int64_t>() != kMissing;
+}
+
+// Whether `value` goes into column `i` rather than the leftover JSON.
+bool fits_column(std::size_t i, const ordered_json& value)
+{
+  return i < kFirstInteger ? value.is_string() : fits_integer(value);
+}
+
+bool compare(ClaimCondition::Op op, std::int64_t value, std::int64_t bound)
+{
+  switch (op)
+  {
+    case ClaimCondition::Op::Equal: return value == bound;
+    case ClaimCondition::Op::NotEqual: return value != bound;
+    case ClaimCondition::Op::Less: return value < bound;
+    case ClaimCondition::Op::LessEqual: return value <= bound;
+    case ClaimCondition::Op::Greater: return value > bound;
+    default: return value >= bound;
+  }
+}
+
+// Whether any value in [min, max] can satisfy the comparison.
+bool may_match(ClaimCondition::Op op, std::int64_t min, std::int64_t max, std::int64_t bound)
+{
+  if (min > max)
+  {
+    return false;
+  }
+
+  switch (op)
+  {
+    case ClaimCondition::Op::Equal: return min <= bound && bound <= max;
+    case ClaimCondition::Op::NotEqual: return min != bound || max != bound;
+    case ClaimCondition::Op::Less: return min < bound;
+    case ClaimCondition::Op::LessEqual: return min <= bound;
+    case ClaimCondition::Op::Greater: return max > bound;
+    default: return max >= bound;
+  }
+}
+
+template <typename Predicate>
+void keep_if(std::vector<std::uint32_t>& rows, Predicate&& keep)
+{
+  rows.erase(std::remove_if(rows.begin(), rows.end(), [&keep](std::uint32_t row) { return !keep(row); }), rows.end());
+}
+
+} // anonymous namespace
+
+std::string_view column_name(ClaimColumn column)
+{
+  return kNames[index_of(column)];
+}
+
+bool find_column(std::string_view name, ClaimColumn& column)
+{
+  for (std::size_t i = 0; i < kClaimColumnCount; ++i)
+  {
+    if (name == kNames[i])
+    {
+      column = static_cast<ClaimColumn>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+ClaimCondition ClaimCondition::parse(std::string_view text)
+{
+  auto at = text.find_first_of("=!<>");
+  if (at == 0 || at == std::string_view::npos)
+  {
+    throw InputError{"Not a condition: " + std::string{text}};
+  }
+
+  ClaimCondition condition;
+  auto name = text.substr(0, at);
+  if (!find_column(name, condition.column))
+  {
+    throw InputError{"Unknown column: " + std::string{name}};
+  }
+
+  auto rest = text.substr(at);
+  auto two = rest.substr(0, 2);
+  if (two == "!=" || two == "<=" || two == ">=")
+  {
+    condition.op = two == "!=" ? Op::NotEqual : two == "<=" ? Op::LessEqual : Op::GreaterEqual;
+    rest.remove_prefix(2);
+  }
+  else if (rest[0] != '!')
+  {
+    condition.op = rest[0] == '=' ? Op::Equal : rest[0] == '<' ? Op::Less : Op::Greater;
+    rest.remove_prefix(1);
+  }
+  else
+  {
+    throw InputError{"Not a condition: " + std::string{text}};
+  }
+  condition.text = std::string{rest};
+
+  auto i = index_of(condition.column);
+  if (i >= kFirstText)
+  {
+    throw InputError{"Cannot filter on " + std::string{name}};
+  }
+  if (i < kFirstInteger)
+  {
+    if (condition.op != Op::Equal && condition.op != Op::NotEqual)
+    {
+      throw InputError{"Only = and != apply to " + std::string{name}};
+    }
+    return condition;
+  }
+
+  auto end = rest.data() + rest.size();
+  auto result = std::from_chars(rest.data(), end, condition.number);
+  if (rest.empty() || result.ec != std::errc{} || result.ptr != end)
+  {
+    throw InputError{"Not an integer: " + condition.text};
+  }
+  return condition;
+}
+
+ClaimTableWriter::ClaimTableWriter(BlockSink sink, std::size_t block_rows)
+  : sink_(std::move(sink))
+  , block_rows_(block_rows)
+{}
+
+std::string_view ClaimTableWriter::file_header()
+{
+  static const std::string header = [] {
+    std::string bytes(kMagic, sizeof(kMagic));
+    put(bytes, kVersion);
+    put(bytes, kByteOrder);
+    return bytes;
+  }();
+  return header;
+}
+
+void ClaimTableWriter::add(const Jwt& token)
+{
+  const auto& header = token.header();
+  const auto& payload = token.payload();
+
+  for (std::size_t i = 0; i < kFirstInteger; ++i)
+  {
+    add_string(strings_[i], find_claim(i < kFirstPayload ? header : payload, kNames[i]));
+  }
+  for (std::size_t i = kFirstInteger; i < kFirstText; ++i)
+  {
+    add_integer(integers_[i - kFirstInteger], find_claim(payload, kNames[i]));
+  }
+  add_rest(rest_[0], header, 0, kFirstPayload);
+  add_rest(rest_[1], payload, kFirstPayload, kFirstText);
+
+  std::size_t chars = rest_[0].chars.size() + rest_[1].chars.size();
+  for (const auto& column : strings_)
+  {
+    chars += column.chars.size();
+  }
+
+  if (++rows_ == block_rows_ || chars >= kMaxBlockChars)
+  {
+    write_block();
+  }
+}
+
+void ClaimTableWriter::finish()
+{
+  if (rows_ > 0)
+  {
+    write_block();
+  }
+}
+
+void ClaimTableWriter::add_string(StringColumn& column, const ordered_json* value)
+{
+  if (value == nullptr || !value->is_string())
+  {
+    column.values.push_back(0);
+    return;
+  }
+
+  // Reusing one key keeps lookups of values already seen from allocating.
+  key_.assign(value->get_ref<const std::string&>());
+  auto it = column.codes.find(key_);
+  if (it == column.codes.end())
+  {
+    it = column.codes.emplace(key_, static_cast<std::uint32_t>(column.codes.size() + 1)).first;
+    column.chars += key_;
+    column.offsets.push_back(static_cast<std::uint32_t>(column.chars.size()));
+  }
+  column.values.push_back(it->second);
+}
+
+void ClaimTableWriter::add_integer(std::vector<std::int64_t>& column, const ordered_json* value)
+{
+  column.push_back(value != nullptr && fits_integer(*value) ? value->get<std::int64_t>() : kMissing);
+}
+
+void ClaimTableWriter::add_rest(TextColumn& column, const ordered_json& object, std::size_t first, std::size_t last)
+{
+  if (!object.is_object())
+  {
+    // A JWE's payload is null.
+    column.chars += object.dump();
+  }
+  else
+  {
+    column.chars += '{';
+    bool empty = true;
+    for (auto it = object.begin(); it != object.end(); ++it)
+    {
+      auto stored = std::find_if(kNames + first, kNames + last, [&it](const char* name) { return it.key() == name; });
+      if (stored != kNames + last && fits_column(static_cast<std::size_t>(stored - kNames), it.value()))
+      {
+        continue;
+      }
+
+      if (!empty)
+      {
+        column.chars += ',';
+      }
+      empty = false;
+      column.chars += ordered_json(it.key()).dump();
+      column.chars += ':';
+      column.chars += it.value().dump();
+    }
+    column.chars += '}';
+  }
+  column.offsets.push_back(static_cast<std::uint32_t>(column.chars.size()));
+}
+
+void ClaimTableWriter::write_block()
+{
+  block_.clear();
+  put<std::uint64_t>(block_, 0);
+  put(block_, static_cast<std::uint32_t>(rows_));
+  put(block_, static_cast<std::uint32_t>(kClaimColumnCount));
+
+  for (const auto& column : integers_)
+  {
+    auto min = std::numeric_limits<std::int64_t>::max();
+    auto max = std::numeric_limits<std::int64_t>::min();
+    for (auto value : column)
+    {
+      if (value != kMissing)
+      {
+        min = std::min(min, value);
+        max = std::max(max, value);
+      }
+    }
+    put(block_, min);
+    put(block_, max);
+  }
+
+  for (auto& column : strings_)
+  {
+    put_section(block_, column.offsets);
+    put_section(block_, column.chars.data(), column.chars.size());
+    put_section(block_, column.values);
+    column = StringColumn{};
+  }
+  for (auto& column : integers_)
+  {
+    put_section(block_, column);
+    column.clear();
+  }
+  for (auto& column : rest_)
+  {
+    put_section(block_, column.offsets);
+    put_section(block_, column.chars.data(), column.chars.size());
+    column = TextColumn{};
+  }
+
+  auto size = static_cast<std::uint64_t>(block_.size() - sizeof(std::uint64_t));
+  std::memcpy(&block_[0], &size, sizeof(size));
+  rows_ = 0;
+
+  sink_(block_);
+}
+
+struct ClaimTable::Block
+{
+  struct Strings
+  {
+    const char* offsets;
+    const char* chars;
+    std::size_t size;
+    const char* codes;
+
+    std::string_view at(std::uint32_t code) const { return slice(offsets, chars, code - 1); }
+  };
+
+  struct Text
+  {
+    const char* offsets;
+    const char* chars;
+  };
+
+  std::uint32_t rows;
+  std::int64_t min[kFirstText - kFirstInteger];
+  std::int64_t max[kFirstText - kFirstInteger];
+
+  Strings strings[kFirstInteger];
+  const char* integers[kFirstText - kFirstInteger];
+  Text text[kClaimColumnCount - kFirstText];
+
+  std::uint32_t code(std::size_t column, std::uint32_t row) const { return load<std::uint32_t>(strings[column].codes, row); }
+  std::int64_t integer(std::size_t column, std::uint32_t row) const { return load<std::int64_t>(integers[column - kFirstInteger], row); }
+};
+
+ClaimTable::ClaimTable(std::string_view data)
+{
+  if (data.size() < kFileHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0)
+  {
+    throw InputError{"Not a claim table"};
+  }
+  if (load<std::uint32_t>(data.data() + sizeof(kMagic), 0) != kVersion)
+  {
+    throw InputError{"Unsupported claim table version"};
+  }
+  if (load<std::uint32_t>(data.data() + sizeof(kMagic), 1) != kByteOrder)
+  {
+    throw InputError{"Claim table was written with a different byte order"};
+  }
+
+  SectionReader file{data.substr(kFileHeaderSize), "Claim table"};
+  while (!file.done())
+  {
+    SectionReader cursor{file.section(1), "Claim table"};
+    Block block;
+    block.rows = cursor.read<std::uint32_t>();
+    if (cursor.read<std::uint32_t>() != kClaimColumnCount)
+    {
+      damaged();
+    }
+    for (std::size_t i = 0; i < kFirstText - kFirstInteger; ++i)
+    {
+      block.min[i] = cursor.read<std::int64_t>();
+      block.max[i] = cursor.read<std::int64_t>();
+    }
+
+    for (auto& column : block.strings)
+    {
+      auto offsets = cursor.section(sizeof(std::uint32_t));
+      auto chars = cursor.section(1);
+      auto codes = cursor.section(sizeof(std::uint32_t));
+      if (offsets.empty() || codes.size() != block.rows * sizeof(std::uint32_t))
+      {
+        damaged();
+      }
+
+      column = Block::Strings{offsets.data(), chars.data(), offsets.size() / sizeof(std::uint32_t) - 1, codes.data()};
+      check_offsets(offsets, column.size, chars);
+      for (std::uint32_t row = 0; row < block.rows; ++row)
+      {
+        if (load<std::uint32_t>(column.codes, row) > column.size)
+        {
+          damaged();
+        }
+      }
+    }
+
+    for (auto& column : block.integers)
+    {
+      auto values = cursor.section(sizeof(std::int64_t));
+      if (values.size() != block.rows * sizeof(std::int64_t))
+      {
+        damaged();
+      }
+      column = values.data();
+    }
+
+    for (auto& column : block.text)
+    {
+      auto offsets = cursor.section(sizeof(std::uint32_t));
+      auto chars = cursor.section(1);
+      check_offsets(offsets, block.rows, chars);
+      column = Block::Text{offsets.data(), chars.data()};
+    }
+
+    if (!cursor.done())
+    {
+      damaged();
+    }
+
+    rows_ += block.rows;
+    blocks_.push_back(block);
+  }
+}
+
+ClaimTable::~ClaimTable() = default;
+
+void ClaimTable::query(const std::vector<ClaimCondition>& conditions, const RowCallback& on_row) const
+{
+  std::vector<std::uint32_t> rows;
+  for (const auto& block : blocks_)
+  {
+    rows.resize(block.rows);
+    std::iota(rows.begin(), rows.end(), 0u);
+
+    for (const auto& condition : conditions)
+    {
+      auto i = index_of(condition.column);
+      if (i < kFirstInteger)
+      {
+        // Compare dictionary codes rather than strings.
+        const auto& column = block.strings[i];
+        std::uint32_t code = 0;
+        for (std::uint32_t c = 1; c <= column.size && code == 0; ++c)
+        {
+          if (column.at(c) == condition.text)
+          {
+            code = c;
+          }
+        }
+
+        if (condition.op == ClaimCondition::Op::Equal)
+        {
+          if (code == 0)
+          {
+            rows.clear();
+            break;
+          }
+          keep_if(rows, [&](std::uint32_t row) { return block.code(i, row) == code; });
+        }
+        else
+        {
+          keep_if(rows, [&](std::uint32_t row) {
+            auto value = block.code(i, row);
+            return value != 0 && value != code;
+          });
+        }
+      }
+      else
+      {
+        auto bound = condition.number;
+        if (!may_match(condition.op, block.min[i - kFirstInteger], block.max[i - kFirstInteger], bound))
+        {
+          rows.clear();
+          break;
+        }
+        keep_if(rows, [&](std::uint32_t row) {
+          auto value = block.integer(i, row);
+          return value != kMissing && compare(condition.op, value, bound);
+        });
+      }
+
+      if (rows.empty())
+      {
+        break;
+      }
+    }
+
+    for (auto row : rows)
+    {
+      on_row(Row{block, row});
+    }
+  }
+}
+
+bool ClaimTable::Row::has(ClaimColumn column) const
+{
+  auto i = index_of(column);
+  if (i < kFirstInteger)
+  {
+    return block_->code(i, row_) != 0;
+  }
+  if (i < kFirstText)
+  {
+    return block_->integer(i, row_) != kMissing;
+  }
+  return true;
+}
+
+std::string_view ClaimTable::Row::text(ClaimColumn column, std::string& scratch) const
+{
+  auto i = index_of(column);
+  if (i < kFirstInteger)
+  {
+    auto code = block_->code(i, row_);
+    return code != 0 ? block_->strings[i].at(code) : std::string_view{};
+  }
+
+  if (i < kFirstText)
+  {
+    auto value = block_->integer(i, row_);
+    if (value == kMissing)
+    {
+      return {};
+    }
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    scratch.assign(buffer, result.ptr);
+    return scratch;
+  }
+
+  const auto& text = block_->text[i - kFirstText];
+  return slice(text.offsets, text.chars, row_);
+}
+
+std::int64_t ClaimTable::Row::number(ClaimColumn column) const
+{
+  return block_->integer(index_of(column), row_);
+}
+
+} // namespace jwt
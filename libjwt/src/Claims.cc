@@ -0,0 +1,81 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Claims.h"
+
+#include <cmath>
+
+namespace jwt {
+
+const ordered_json* find_claim(const ordered_json& object, const char* name)
+{
+  if (!object.is_object())
+  {
+    return nullptr;
+  }
+  auto it = object.find(name);
+  return it != object.end() ? &*it : nullptr;
+}
+
+std::string_view claim_text(const ordered_json& value, std::string& scratch)
+{
+  if (value.is_string())
+  {
+    return value.get_ref<const std::string&>();
+  }
+  scratch = value.dump();
+  return scratch;
+}
+
+bool get_seconds(const ordered_json& object, const char* name, std::int64_t& seconds)
+{
+  auto* value = find_claim(object, name);
+  if (value == nullptr || !value->is_number())
+  {
+    return false;
+  }
+
+  // Some 30 million years either way; beyond that, arithmetic on times such
+  // as bucketing them could overflow.
+  constexpr std::int64_t kMaxSeconds = 1000000000000000;
+
+  if (value->is_number_float())
+  {
+    auto real = value->get<double>();
+    if (!std::isfinite(real) || std::fabs(real) > static_cast<double>(kMaxSeconds))
+    {
+      return false;
+    }
+    seconds = static_cast<std::int64_t>(std::floor(real));
+    return true;
+  }
+
+  if (value->is_number_unsigned())
+  {
+    if (value->get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxSeconds))
+    {
+      return false;
+    }
+    seconds = static_cast<std::int64_t>(value->get<std::uint64_t>());
+    return true;
+  }
+
+  seconds = value->get<std::int64_t>();
+  return seconds >= -kMaxSeconds && seconds <= kMaxSeconds;
+}
+
+} // namespace jwt
@@ -0,0 +1,47 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_CLAIMS_H
+#define JWT_LIB_CLAIMS_H
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "libjwt/JsonVisitor.h"
+
+namespace jwt {
+
+// The member `name` of `object`, or null if there is none or `object` is not
+// an object at all, as for a JWE's payload.
+const ordered_json* find_claim(const ordered_json& object, const char* name);
+
+// Claims are nearly always strings; anything else is represented by its JSON
+// text, kept in `scratch`.  So 123 and "123" give the same text and are
+// counted, sketched and indexed as one value, which is also what lets
+// --index query sub=123 find either.
+std::string_view claim_text(const ordered_json& value, std::string& scratch);
+
+// Reads a NumericDate claim such as "exp", in whole seconds since the epoch.
+// Returns false if it is missing or not a plausible number.
+bool get_seconds(const ordered_json& object, const char* name, std::int64_t& seconds);
+
+} // namespace jwt
+
+#endif // JWT_LIB_CLAIMS_H
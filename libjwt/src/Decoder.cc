@@ -0,0 +1,368 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/Decoder.h"
+
+#include <array>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "libjwt/InputError.h"
+#include "libjwt/Stats.h"
+#include "libjwt/Trace.h"
+
+#include "Base64.h"
+
+namespace jwt {
+
+namespace {
+
+// A JWE compact serialization has the most segments: header, encrypted key,
+// initialization vector, ciphertext and authentication tag.
+constexpr std::size_t kMaxSegments = 5;
+
+using Segments = std::array<std::string_view, kMaxSegments>;
+
+bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Splits a compact serialization on '.', ignoring surrounding whitespace,
+// without copying.  Returns the number of segments found, which may exceed
+// kMaxSegments; only the first kMaxSegments are stored.
+std::size_t split_segments(std::string_view text, Segments& segments)
+{
+  const char* begin = text.data();
+  const char* end = begin + text.size();
+
+  while (begin != end && is_space(*begin)) ++begin;
+  while (end != begin && is_space(*(end - 1))) --end;
+
+  std::size_t count = 0;
+  while (true)
+  {
+    auto dot = begin != end
+        ? static_cast<const char*>(std::memchr(begin, '.', static_cast<std::size_t>(end - begin)))
+        : nullptr;
+    auto segment_end = dot != nullptr ? dot : end;
+
+    if (count < kMaxSegments)
+    {
+      segments[count] = std::string_view{begin, static_cast<std::size_t>(segment_end - begin)};
+    }
+    ++count;
+
+    if (dot == nullptr)
+    {
+      return count;
+    }
+    begin = dot + 1;
+  }
+}
+
+// Offset of the first extra '.' in a token with too many segments, or of the
+// end of the token if it has too few.
+std::size_t segment_count_error_position(std::string_view encoded, const Segments& parts, std::size_t num_parts)
+{
+  auto offset_of = [&](const char* p) { return static_cast<std::size_t>(p - encoded.data()); };
+
+  if (num_parts < 2)
+  {
+    return offset_of(parts[0].data() + parts[0].size());
+  }
+  if (num_parts == 4)
+  {
+    return offset_of(parts[3].data() - 1);
+  }
+  return offset_of(parts[4].data() + parts[4].size());
+}
+
+// Builds an ordered_json from nlohmann's SAX events, using a caller-owned
+// container stack, and records where parsing failed instead of throwing.
+class DomBuilder
+{
+public:
+  DomBuilder(ordered_json& root, std::vector<ordered_json*>& stack)
+    : root_(root)
+    , stack_(stack)
+  {
+    stack_.clear();
+  }
+
+  bool null()
+  {
+    add(nullptr);
+    return true;
+  }
+
+  bool boolean(bool value)
+  {
+    add(value);
+    return true;
+  }
+
+  bool number_integer(ordered_json::number_integer_t value)
+  {
+    add(value);
+    return true;
+  }
+
+  bool number_unsigned(ordered_json::number_unsigned_t value)
+  {
+    add(value);
+    return true;
+  }
+
+  bool number_float(ordered_json::number_float_t value, const ordered_json::string_t&)
+  {
+    add(value);
+    return true;
+  }
+
+  bool string(ordered_json::string_t& value)
+  {
+    add(value);
+    return true;
+  }
+
+  bool binary(ordered_json::binary_t&)
+  {
+    // Only reachable when parsing binary formats, which we never do.
+    return false;
+  }
+
+  bool start_object(std::size_t)
+  {
+    stack_.push_back(add(ordered_json::value_t::object));
+    return true;
+  }
+
+  bool key(ordered_json::string_t& name)
+  {
+    // The lexer reuses `name`'s storage for the next token, so claim the
+    // slot now rather than holding on to it.
+    field_ = &(*stack_.back())[name];
+    return true;
+  }
+
+  bool end_object()
+  {
+    stack_.pop_back();
+    return true;
+  }
+
+  bool start_array(std::size_t)
+  {
+    stack_.push_back(add(ordered_json::value_t::array));
+    return true;
+  }
+
+  bool end_array()
+  {
+    stack_.pop_back();
+    return true;
+  }
+
+  template <typename Exception>
+  bool parse_error(std::size_t position, const std::string&, const Exception&)
+  {
+    // nlohmann counts the offending character as already read.
+    error_position = position > 0 ? position - 1 : 0;
+    return false;
+  }
+
+  std::size_t error_position {0};
+
+private:
+  template <typename Value>
+  ordered_json* add(Value&& value)
+  {
+    if (stack_.empty())
+    {
+      root_ = std::forward<Value>(value);
+      return &root_;
+    }
+
+    auto* parent = stack_.back();
+    if (parent->is_array())
+    {
+      parent->emplace_back(std::forward<Value>(value));
+      return &parent->back();
+    }
+
+    *field_ = std::forward<Value>(value);
+    return field_;
+  }
+
+  ordered_json& root_;
+  std::vector<ordered_json*>& stack_;
+  ordered_json* field_ {nullptr};
+};
+
+bool decode_segment(std::string_view encoded,
+                    std::string_view segment,
+                    JwtError::Segment which,
+                    std::string& decoded,
+                    ordered_json& json,
+                    std::vector<ordered_json*>& json_stack,
+                    JwtError& error)
+{
+  std::size_t position;
+  bool decoded_ok;
+  {
+    ScopedPhase phase{Phase::Base64Decode, segment.size()};
+    decoded_ok = base64_urlsafe_decode(segment, decoded, position);
+  }
+
+  if (!decoded_ok)
+  {
+    error.code = JwtError::Code::Base64;
+    error.segment = which;
+    error.position = static_cast<std::size_t>(segment.data() - encoded.data()) + position;
+    return false;
+  }
+
+  DomBuilder builder{json, json_stack};
+  bool parsed_ok;
+  {
+    ScopedPhase phase{Phase::JsonParse, decoded.size()};
+    parsed_ok = ordered_json::sax_parse(decoded.begin(), decoded.end(), &builder);
+  }
+
+  if (!parsed_ok)
+  {
+    error.code = JwtError::Code::Json;
+    error.segment = which;
+    error.position = builder.error_position;
+    return false;
+  }
+
+  return true;
+}
+
+} // anonymous namespace
+
+Decoder::Decoder() = default;
+
+Decoder::~Decoder() = default;
+
+void Decoder::parse_into(std::string_view encoded, Jwt& out)
+{
+  JwtError error;
+  if (!try_parse_into(encoded, out, error))
+  {
+    throw InputError{error.message()};
+  }
+}
+
+bool Decoder::try_parse_into(std::string_view encoded, Jwt& out, JwtError& error)
+{
+  ScopedSpan span{"token"};
+  auto ok = decode(encoded, out, error);
+
+  if (auto* stats = current_stats())
+  {
+    if (ok)
+    {
+      stats->record_token();
+    }
+    else
+    {
+      stats->record_error(error.code);
+    }
+  }
+
+  return ok;
+}
+
+bool Decoder::decode(std::string_view encoded, Jwt& out, JwtError& error)
+{
+  error = JwtError{};
+
+  Segments parts;
+  std::size_t num_parts;
+  {
+    ScopedPhase phase{Phase::Split, encoded.size()};
+    num_parts = split_segments(encoded, parts);
+  }
+  if (num_parts != 2 && num_parts != 3 && num_parts != kMaxSegments)
+  {
+    error.code = JwtError::Code::SegmentCount;
+    error.position = segment_count_error_position(encoded, parts, num_parts);
+    return false;
+  }
+
+  if (!decode_segment(encoded, parts[0], JwtError::Segment::Header, out.original_header_, out.header_, json_stack_, error))
+  {
+    return false;
+  }
+
+  if (num_parts == kMaxSegments)
+  {
+    // JWE: everything past the header is binary, and the payload is encrypted.
+    out.original_payload_.clear();
+    out.signature_.clear();
+    out.payload_ = nullptr;
+    out.encrypted_key_.assign(parts[1]);
+    out.initialization_vector_.assign(parts[2]);
+    out.ciphertext_.assign(parts[3]);
+    out.authentication_tag_.assign(parts[4]);
+    return true;
+  }
+
+  if (!decode_segment(encoded, parts[1], JwtError::Segment::Payload, out.original_payload_, out.payload_, json_stack_, error))
+  {
+    return false;
+  }
+
+  if (num_parts == 3)
+  {
+    out.signature_.assign(parts[2]); // no need to decode this, it's binary data
+  }
+  else
+  {
+    out.signature_.clear();
+  }
+
+  out.encrypted_key_.clear();
+  out.initialization_vector_.clear();
+  out.ciphertext_.clear();
+  out.authentication_tag_.clear();
+  return true;
+}
+
+std::ostream& Decoder::print(std::ostream& os, const ordered_json& json, bool use_ansi_colors)
+{
+  auto& printer = use_ansi_colors ? ansi_printer_ : printer_;
+  if (!printer)
+  {
+    printer = std::make_unique<JsonPrinter>(use_ansi_colors);
+  }
+  return printer->print(os, json);
+}
+
+std::ostream& Decoder::print_binary(std::ostream& os, const Jwt& token, BinaryFormat format)
+{
+  frame_.clear();
+  append_frame(frame_, token, format);
+  return os.write(frame_.data(), static_cast<std::streamsize>(frame_.size()));
+}
+
+} // namespace jwt
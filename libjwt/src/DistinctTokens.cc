@@ -0,0 +1,126 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/DistinctTokens.h"
+
+#include <algorithm>
+
+namespace jwt {
+
+namespace {
+
+constexpr std::size_t kInitialSlots = 256;
+
+} // anonymous namespace
+
+// Slots hold the full hash, so that probing and growing never touch the
+// entries themselves.  Tables stay at most half full.
+struct DistinctTokens::Shard
+{
+  struct Slot
+  {
+    Hash128 hash;
+
+    // One past the index into entries, or 0 for an empty slot.
+    std::uint32_t entry {0};
+  };
+
+  std::mutex mutex;
+  std::vector<Slot> slots = std::vector<Slot>(kInitialSlots);
+  std::vector<Entry> entries;
+
+  Slot& find(const Hash128& hash)
+  {
+    auto mask = slots.size() - 1;
+    for (auto i = static_cast<std::size_t>(hash.low) & mask; ; i = (i + 1) & mask)
+    {
+      auto& slot = slots[i];
+      if (slot.entry == 0 || slot.hash == hash)
+      {
+        return slot;
+      }
+    }
+  }
+
+  void grow()
+  {
+    std::vector<Slot> old(slots.size() * 2);
+    old.swap(slots);
+    for (const auto& slot : old)
+    {
+      if (slot.entry != 0)
+      {
+        find(slot.hash) = slot;
+      }
+    }
+  }
+};
+
+DistinctTokens::DistinctTokens(std::size_t num_shards)
+{
+  // Shards are picked by the high bits of the hash, slots by the low ones.
+  for (std::size_t i = 0; i < std::max<std::size_t>(num_shards, 1); ++i)
+  {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+DistinctTokens::~DistinctTokens() = default;
+
+void DistinctTokens::add(std::string_view token, const Position& position)
+{
+  auto hash = murmur3_128(token);
+  auto& shard = *shards_[static_cast<std::size_t>(hash.high % shards_.size())];
+
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  auto* slot = &shard.find(hash);
+  if (slot->entry != 0)
+  {
+    auto& entry = shard.entries[slot->entry - 1];
+    ++entry.count;
+    if (position < entry.first)
+    {
+      entry.first = position;
+    }
+    return;
+  }
+
+  if ((shard.entries.size() + 1) * 2 > shard.slots.size())
+  {
+    shard.grow();
+    slot = &shard.find(hash);
+  }
+
+  shard.entries.push_back(Entry{std::string{token}, position, 1});
+  slot->hash = hash;
+  slot->entry = static_cast<std::uint32_t>(shard.entries.size());
+}
+
+std::vector<DistinctTokens::Entry> DistinctTokens::entries() const
+{
+  std::vector<Entry> result;
+  for (const auto& shard : shards_)
+  {
+    std::lock_guard<std::mutex> lock{shard->mutex};
+    result.insert(result.end(), shard->entries.begin(), shard->entries.end());
+  }
+
+  std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) { return a.first < b.first; });
+  return result;
+}
+
+} // namespace jwt
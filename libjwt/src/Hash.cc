@@ -0,0 +1,118 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/Hash.h"
+
+#include <cstring>
+
+namespace jwt {
+
+namespace {
+
+std::uint64_t rotl(std::uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+std::uint64_t fmix(std::uint64_t k)
+{
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+// Blocks are read little-endian, as on every platform we build for.
+std::uint64_t load(const char* p)
+{
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+} // anonymous namespace
+
+Hash128 murmur3_128(std::string_view data, std::uint32_t seed)
+{
+  constexpr std::uint64_t c1 = 0x87c37b91114253d5ULL;
+  constexpr std::uint64_t c2 = 0x4cf5ad432745937fULL;
+
+  const char* p = data.data();
+  const std::size_t size = data.size();
+  const std::size_t num_blocks = size / 16;
+
+  std::uint64_t h1 = seed;
+  std::uint64_t h2 = seed;
+
+  for (std::size_t i = 0; i < num_blocks; ++i, p += 16)
+  {
+    auto k1 = load(p);
+    auto k2 = load(p + 8);
+
+    k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+    h1 = rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+    k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+    h2 = rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+  }
+
+  // The last 0-15 bytes, again little-endian.
+  const auto* tail = reinterpret_cast<const unsigned char*>(p);
+  std::uint64_t k1 = 0;
+  std::uint64_t k2 = 0;
+  switch (size & 15)
+  {
+    case 15: k2 ^= std::uint64_t{tail[14]} << 48; [[fallthrough]];
+    case 14: k2 ^= std::uint64_t{tail[13]} << 40; [[fallthrough]];
+    case 13: k2 ^= std::uint64_t{tail[12]} << 32; [[fallthrough]];
+    case 12: k2 ^= std::uint64_t{tail[11]} << 24; [[fallthrough]];
+    case 11: k2 ^= std::uint64_t{tail[10]} << 16; [[fallthrough]];
+    case 10: k2 ^= std::uint64_t{tail[9]} << 8; [[fallthrough]];
+    case 9:
+      k2 ^= std::uint64_t{tail[8]};
+      k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+      [[fallthrough]];
+    case 8: k1 ^= std::uint64_t{tail[7]} << 56; [[fallthrough]];
+    case 7: k1 ^= std::uint64_t{tail[6]} << 48; [[fallthrough]];
+    case 6: k1 ^= std::uint64_t{tail[5]} << 40; [[fallthrough]];
+    case 5: k1 ^= std::uint64_t{tail[4]} << 32; [[fallthrough]];
+    case 4: k1 ^= std::uint64_t{tail[3]} << 24; [[fallthrough]];
+    case 3: k1 ^= std::uint64_t{tail[2]} << 16; [[fallthrough]];
+    case 2: k1 ^= std::uint64_t{tail[1]} << 8; [[fallthrough]];
+    case 1:
+      k1 ^= std::uint64_t{tail[0]};
+      k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+  }
+
+  h1 ^= size;
+  h2 ^= size;
+
+  h1 += h2;
+  h2 += h1;
+
+  h1 = fmix(h1);
+  h2 = fmix(h2);
+
+  h1 += h2;
+  h2 += h1;
+
+  return Hash128{h1, h2};
+}
+
+} // namespace jwt
@@ -25,8 +25,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <sstream>
 #include <stack>
 #include <utility>
+#include <vector>
 
 #include "libjwt/config.h"
+#include "libjwt/Stats.h"
 
 #include "termcolor.hpp"
 
@@ -36,13 +38,25 @@ namespace {
 
 constexpr const char* indent_unit = "  ";
 
+}
+
 class PrintingJsonVisitor : public IJsonVisitor
 {
 public:
   PrintingJsonVisitor(std::ostream& os)
-    : os_(os)
+    : os_(&os)
   {}
 
+  // Points the visitor at a new stream, keeping its context stack's storage.
+  void reset(std::ostream& os)
+  {
+    os_ = &os;
+    while (!contexts_.empty())
+    {
+      contexts_.pop();
+    }
+  }
+
   virtual void on_object_start() override
   {
     write_separator();
@@ -133,7 +147,7 @@ public:
 protected:
   std::ostream& os()
   {
-    return os_;
+    return *os_;
   }
 
 protected:
@@ -210,10 +224,12 @@ private:
     bool expecting_field_value {false};
   };
 
-  std::ostream& os_;
-  std::stack<Context> contexts_;
+  std::ostream* os_;
+  std::stack<Context, std::vector<Context>> contexts_;
 };
 
+namespace {
+
 class AnsiColor
 {
 public:
@@ -265,17 +281,49 @@ public:
   }
 };
 
+std::unique_ptr<PrintingJsonVisitor> make_printing_visitor(std::ostream& os, bool use_ansi_colors)
+{
+  if (use_ansi_colors)
+  {
+    return std::make_unique<AnsiPrintingJsonVisitor>(os);
+  }
+  return std::make_unique<PrintingJsonVisitor>(os);
 }
 
-std::ostream& pretty_print_json(std::ostream& os, const ordered_json& json, bool use_ansi_colors)
+}
+
+JsonPrinter::JsonPrinter(bool use_ansi_colors)
+    : visitor_(make_printing_visitor(std::cout, use_ansi_colors))
+{}
+
+JsonPrinter::~JsonPrinter() = default;
+
+std::ostream& JsonPrinter::print(std::ostream& os, const ordered_json& json)
 {
-  std::unique_ptr<IJsonVisitor> visitor = use_ansi_colors
-      ? std::make_unique<AnsiPrintingJsonVisitor>(os)
-      : std::make_unique<PrintingJsonVisitor>(os);
+  ScopedPhase phase{Phase::Print};
 
-  visit(json, *visitor);
+  visitor_->reset(os);
+  visit(json, *visitor_);
+  return os;
+}
+
+std::ostream& JsonPrinter::print(std::ostream& os, const Tape& tape, std::size_t root)
+{
+  ScopedPhase phase{Phase::Print};
 
+  visitor_->reset(os);
+  visit(tape, root, *visitor_);
   return os;
 }
 
+std::ostream& pretty_print_json(std::ostream& os, const ordered_json& json, bool use_ansi_colors)
+{
+  return JsonPrinter{use_ansi_colors}.print(os, json);
+}
+
+std::ostream& pretty_print_json(std::ostream& os, const Tape& tape, std::size_t root, bool use_ansi_colors)
+{
+  return JsonPrinter{use_ansi_colors}.print(os, tape, root);
+}
+
 }
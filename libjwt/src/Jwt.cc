@@ -17,92 +17,51 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libjwt/Jwt.h"
 
-#include <algorithm>
-#include <iostream>
-#include <iterator>
-#include <sstream>
-#include <vector>
+#include <utility>
 
+#include "libjwt/Decoder.h"
 #include "libjwt/InputError.h"
 
-#include "Base64.h"
-
 namespace jwt {
 
-namespace {
-
-template <typename Out>
-void split(const std::string& str, char delimiter, Out&& result)
+Jwt Jwt::parse(std::string_view encoded)
 {
-  std::stringstream ss(str);
-  std::string item;
-  while (std::getline(ss, item, delimiter))
+  JwtError error;
+  auto token = try_parse(encoded, error);
+  if (!token)
   {
-    *(result++) = item;
+    throw InputError{error.message()};
   }
+  return std::move(*token);
 }
 
-std::vector<std::string> split(const std::string& str, char delimiter)
-{
-  std::vector<std::string> result;
-  split(str, delimiter, std::back_inserter(result));
-  return result;
-}
-
-std::string trim(const std::string& text)
+std::optional<Jwt> Jwt::try_parse(std::string_view encoded, JwtError& error)
 {
-  auto begin = text.find_first_not_of(" \t");
-  if (begin == std::string::npos)
+  std::optional<Jwt> token{std::in_place};
+  Decoder decoder;
+  if (!decoder.try_parse_into(encoded, *token, error))
   {
-    return "";
+    return std::nullopt;
   }
-
-  auto end = text.find_last_not_of(" \t");
-  auto range = end - begin + 1;
-  return text.substr(begin, range);
-}
-
-} // anonymous namespace
-
-Jwt Jwt::parse(const std::string& encoded)
-{
-  std::vector<std::string> parts = split(trim(encoded), '.');
-  if (parts.size() != 2 && parts.size() != 3)
-  {
-    throw InputError{"expected two or three segments delimited with a '.'"};
-  }
-
-  auto encoded_header = parts[0];
-  auto encoded_payload = parts[1];
-
-  auto header = encoded_header.size() != 0 ? base64_urlsafe_decode(encoded_header) : "";
-  auto payload = encoded_payload.size() != 0 ? base64_urlsafe_decode(encoded_payload) : "";
-  std::string signature;
-  if (parts.size() == 3)
-  {
-    auto encoded_signature = trim(parts[2]);
-    signature = encoded_signature; // no need to decode this, it's binary data
-  }
-
-  return Jwt{header, payload, signature, ordered_json::parse(header), ordered_json::parse(payload)};
+  return token;
 }
 
-Jwt::Jwt(const std::string& original_header,
-         const std::string& original_payload,
-         const std::string& signature,
-         const ordered_json& header,
-         const ordered_json& payload)
-    : original_header_(original_header)
-    , original_payload_(original_payload)
-    , signature_(signature)
-    , header_(header)
-    , payload_(payload)
+Jwt::Jwt(std::string original_header,
+         std::string original_payload,
+         std::string signature,
+         ordered_json header,
+         ordered_json payload)
+    : original_header_(std::move(original_header))
+    , original_payload_(std::move(original_payload))
+    , signature_(std::move(signature))
+    , header_(std::move(header))
+    , payload_(std::move(payload))
 {
 }
 
 bool Jwt::is_encrypted() const
 {
-  return header_["typ"] == "JWE";
+  return !ciphertext_.empty() || header_["typ"] == "JWE";
 }
 
 bool Jwt::is_signed() const
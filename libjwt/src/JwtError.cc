@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/JwtError.h"
+
+namespace jwt {
+
+std::string JwtError::message() const
+{
+  const char* segment_name = segment == Segment::Header ? "header" : "payload";
+
+  switch (code)
+  {
+    case Code::None:
+      return "no error";
+
+    case Code::SegmentCount:
+      return "expected two, three or five segments delimited with a '.'";
+
+    case Code::Base64:
+      return std::string{"illegal base64 in "} + segment_name + " at offset " + std::to_string(position);
+
+    case Code::Json:
+      return std::string{"invalid JSON in "} + segment_name + " at decoded offset " + std::to_string(position);
+  }
+
+  return "unknown error";
+}
+
+} // namespace jwt
@@ -0,0 +1,191 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/RowFormatter.h"
+
+#include <charconv>
+#include <ostream>
+
+#include "Claims.h"
+
+namespace jwt {
+
+namespace {
+
+constexpr std::string_view kHeaderPrefix = "header.";
+constexpr std::string_view kPayloadPrefix = "payload.";
+
+template <typename Integer>
+void write_integer(std::ostream& os, Integer value)
+{
+  char buffer[24];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  os.write(buffer, result.ptr - buffer);
+}
+
+} // anonymous namespace
+
+RowFormatter::RowFormatter(Format format, const std::vector<std::string>& columns)
+  : format_(format)
+  , delimiter_(format == Format::Tsv ? '\t' : ',')
+{
+  for (const auto& name : columns)
+  {
+    std::string_view claim = name;
+    auto source = Source::Either;
+    if (claim.substr(0, kHeaderPrefix.size()) == kHeaderPrefix)
+    {
+      claim.remove_prefix(kHeaderPrefix.size());
+      source = Source::Header;
+    }
+    else if (claim.substr(0, kPayloadPrefix.size()) == kPayloadPrefix)
+    {
+      claim.remove_prefix(kPayloadPrefix.size());
+      source = Source::Payload;
+    }
+
+    columns_.push_back(Column{name, std::string{claim}, source});
+  }
+}
+
+void RowFormatter::write_header(std::ostream& os) const
+{
+  for (std::size_t i = 0; i < columns_.size(); ++i)
+  {
+    if (i > 0)
+    {
+      os.put(delimiter_);
+    }
+    write_field(os, columns_[i].name);
+  }
+  os.put('\n');
+}
+
+void RowFormatter::write_row(std::ostream& os, const Jwt& token) const
+{
+  for (std::size_t i = 0; i < columns_.size(); ++i)
+  {
+    if (i > 0)
+    {
+      os.put(delimiter_);
+    }
+    if (auto* value = find(token, columns_[i]))
+    {
+      write_value(os, *value);
+    }
+  }
+  os.put('\n');
+}
+
+void RowFormatter::write_row(std::ostream& os, const std::vector<std::string_view>& fields) const
+{
+  for (std::size_t i = 0; i < fields.size(); ++i)
+  {
+    if (i > 0)
+    {
+      os.put(delimiter_);
+    }
+    write_field(os, fields[i]);
+  }
+  os.put('\n');
+}
+
+const ordered_json* RowFormatter::find(const Jwt& token, const Column& column) const
+{
+  const ordered_json* value = nullptr;
+  if (column.source != Source::Header)
+  {
+    value = find_claim(token.payload(), column.claim.c_str());
+  }
+  if (value == nullptr && column.source != Source::Payload)
+  {
+    value = find_claim(token.header(), column.claim.c_str());
+  }
+  return value;
+}
+
+void RowFormatter::write_value(std::ostream& os, const ordered_json& value) const
+{
+  switch (value.type())
+  {
+    case ordered_json::value_t::string:
+      write_field(os, value.get_ref<const std::string&>());
+      break;
+
+    case ordered_json::value_t::number_integer:
+      write_integer(os, value.get<std::int64_t>());
+      break;
+
+    case ordered_json::value_t::number_unsigned:
+      write_integer(os, value.get<std::uint64_t>());
+      break;
+
+    case ordered_json::value_t::boolean:
+      os << (value.get<bool>() ? "true" : "false");
+      break;
+
+    case ordered_json::value_t::null:
+      break;
+
+    default:
+      // Floats, objects and arrays are rare enough to go through dump().
+      write_field(os, value.dump());
+      break;
+  }
+}
+
+void RowFormatter::write_field(std::ostream& os, std::string_view text) const
+{
+  if (format_ == Format::Tsv)
+  {
+    // Most fields need no escaping at all, so copy runs between escapes.
+    std::size_t start = 0;
+    for (std::size_t i = text.find_first_of("\t\n\r\\"); i != std::string_view::npos; i = text.find_first_of("\t\n\r\\", start))
+    {
+      os.write(text.data() + start, static_cast<std::streamsize>(i - start));
+      switch (text[i])
+      {
+        case '\t': os << "\\t"; break;
+        case '\n': os << "\\n"; break;
+        case '\r': os << "\\r"; break;
+        default: os << "\\\\"; break;
+      }
+      start = i + 1;
+    }
+    os.write(text.data() + start, static_cast<std::streamsize>(text.size() - start));
+    return;
+  }
+
+  if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+  {
+    os.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return;
+  }
+
+  os.put('"');
+  std::size_t start = 0;
+  for (auto i = text.find('"'); i != std::string_view::npos; i = text.find('"', start))
+  {
+    os.write(text.data() + start, static_cast<std::streamsize>(i + 1 - start));
+    os.put('"');
+    start = i + 1;
+  }
+  os.write(text.data() + start, static_cast<std::streamsize>(text.size() - start));
+  os.put('"');
+}
+
+} // namespace jwt
@@ -0,0 +1,115 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_LIB_SECTIONS_H
+#define JWT_LIB_SECTIONS_H
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libjwt/InputError.h"
+
+// Helpers for the binary files libjwt writes, such as claim tables and
+// indexes.  Values are stored in native byte order; files record it in their
+// header to catch a mismatch.  Variable-length data is stored in sections,
+// each its length in bytes followed by its contents, padded so that the next
+// one starts 8-byte aligned.
+
+namespace jwt {
+
+template <typename T>
+void put(std::string& out, T value)
+{
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline void put_section(std::string& out, const void* data, std::size_t size)
+{
+  put<std::uint64_t>(out, size);
+  out.append(static_cast<const char*>(data), size);
+  out.append((8 - size % 8) % 8, '\0');
+}
+
+template <typename T>
+void put_section(std::string& out, const std::vector<T>& values)
+{
+  put_section(out, values.data(), values.size() * sizeof(T));
+}
+
+// Reads through memcpy, so that the data need not be aligned.
+template <typename T>
+T load(const char* data, std::size_t index)
+{
+  T value;
+  std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+  return value;
+}
+
+// Reads values and sections from the front of `data`, throwing InputError
+// if it runs short.
+class SectionReader
+{
+public:
+  // `what` names the kind of file in errors, e.g. "Claim table".
+  SectionReader(std::string_view data, const char* what) : data_(data), what_(what) {}
+
+  template <typename T>
+  T read()
+  {
+    if (data_.size() < sizeof(T))
+    {
+      fail();
+    }
+    auto value = load<T>(data_.data(), 0);
+    data_.remove_prefix(sizeof(T));
+    return value;
+  }
+
+  // The next section, which must hold whole elements of `element_size`.
+  std::string_view section(std::size_t element_size)
+  {
+    auto size = read<std::uint64_t>();
+    auto padded = size + (8 - size % 8) % 8;
+    if (size % element_size != 0 || padded < size || padded > data_.size())
+    {
+      fail();
+    }
+    auto contents = data_.substr(0, static_cast<std::size_t>(size));
+    data_.remove_prefix(static_cast<std::size_t>(padded));
+    return contents;
+  }
+
+  bool done() const { return data_.empty(); }
+
+  [[noreturn]] void fail() const
+  {
+    throw InputError{std::string{what_} + " is truncated or damaged"};
+  }
+
+private:
+  std::string_view data_;
+  const char* what_;
+};
+
+} // namespace jwt
+
+#endif // JWT_LIB_SECTIONS_H
@@ -0,0 +1,239 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/Sketches.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace jwt {
+
+HyperLogLog::HyperLogLog(unsigned precision)
+  : precision_(precision)
+{
+  if (precision < 4 || precision > 18)
+  {
+    throw std::invalid_argument("HyperLogLog precision must be between 4 and 18");
+  }
+  registers_.resize(std::size_t{1} << precision);
+}
+
+void HyperLogLog::add(std::uint64_t hash)
+{
+  auto index = static_cast<std::size_t>(hash >> (64 - precision_));
+
+  // The rank is the position of the first set bit after the index bits.  A
+  // sentinel bit past the end caps it, and ends the loop.
+  auto rest = (hash << precision_) | (std::uint64_t{1} << (precision_ - 1));
+  std::uint8_t rank = 1;
+  while ((rest & (std::uint64_t{1} << 63)) == 0)
+  {
+    ++rank;
+    rest <<= 1;
+  }
+
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other)
+{
+  if (other.precision_ != precision_)
+  {
+    throw std::invalid_argument("Cannot merge HyperLogLogs of different precision");
+  }
+
+  for (std::size_t i = 0; i < registers_.size(); ++i)
+  {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+double HyperLogLog::estimate() const
+{
+  const auto m = static_cast<double>(registers_.size());
+
+  double sum = 0;
+  std::size_t zeros = 0;
+  for (auto rank : registers_)
+  {
+    sum += std::ldexp(1.0, -rank);
+    zeros += rank == 0 ? 1 : 0;
+  }
+
+  const auto alpha = 0.7213 / (1 + 1.079 / m);
+  auto estimate = alpha * m * m / sum;
+
+  // Small cardinalities leave registers empty; linear counting is more
+  // accurate there.  With 64-bit hashes, large ones need no correction.
+  if (estimate <= 2.5 * m && zeros > 0)
+  {
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return estimate;
+}
+
+TopK::TopK(std::size_t capacity)
+  : capacity_(std::max<std::size_t>(capacity, 1))
+{
+  entries_.reserve(capacity_);
+  heap_.reserve(capacity_);
+  heap_positions_.reserve(capacity_);
+  index_.reserve(capacity_);
+}
+
+void TopK::add(std::string_view value, std::uint64_t count)
+{
+  add(value, count, 0);
+}
+
+void TopK::add(std::string_view value, std::uint64_t count, std::uint64_t error)
+{
+  auto it = index_.find(value);
+  if (it != index_.end())
+  {
+    auto& entry = entries_[it->second];
+    entry.count += count;
+    entry.error += error;
+    sift_down(heap_positions_[it->second]);
+    return;
+  }
+
+  if (entries_.size() < capacity_)
+  {
+    auto index = entries_.size();
+    entries_.push_back(Entry{std::string{value}, count, error});
+    index_.emplace(entries_.back().value, index);
+
+    heap_.push_back(index);
+    heap_positions_.push_back(heap_.size() - 1);
+    sift_up(heap_.size() - 1);
+    return;
+  }
+
+  // Evict the least frequent value.  The newcomer may have occurred up to
+  // that many times already without being tracked.
+  auto index = heap_.front();
+  auto& entry = entries_[index];
+  index_.erase(entry.value);
+
+  entry.value.assign(value.data(), value.size());
+  entry.error = entry.count + error;
+  entry.count += count;
+  index_.emplace(entry.value, index);
+  sift_down(0);
+}
+
+bool TopK::heap_less(std::size_t a, std::size_t b) const
+{
+  return entries_[heap_[a]].count < entries_[heap_[b]].count;
+}
+
+void TopK::heap_swap(std::size_t a, std::size_t b)
+{
+  std::swap(heap_[a], heap_[b]);
+  heap_positions_[heap_[a]] = a;
+  heap_positions_[heap_[b]] = b;
+}
+
+void TopK::sift_up(std::size_t position)
+{
+  while (position > 0)
+  {
+    auto parent = (position - 1) / 2;
+    if (!heap_less(position, parent))
+    {
+      return;
+    }
+    heap_swap(position, parent);
+    position = parent;
+  }
+}
+
+void TopK::sift_down(std::size_t position)
+{
+  while (true)
+  {
+    auto smallest = position;
+    auto left = 2 * position + 1;
+    auto right = left + 1;
+    if (left < heap_.size() && heap_less(left, smallest))
+    {
+      smallest = left;
+    }
+    if (right < heap_.size() && heap_less(right, smallest))
+    {
+      smallest = right;
+    }
+    if (smallest == position)
+    {
+      return;
+    }
+
+    heap_swap(position, smallest);
+    position = smallest;
+  }
+}
+
+void TopK::merge(const TopK& other)
+{
+  for (const auto& entry : other.entries_)
+  {
+    add(entry.value, entry.count, entry.error);
+  }
+}
+
+std::vector<TopK::Entry> TopK::top(std::size_t k) const
+{
+  std::vector<Entry> result{entries_};
+  std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) {
+    return a.count != b.count ? a.count > b.count : a.value < b.value;
+  });
+
+  if (result.size() > k)
+  {
+    result.resize(k);
+  }
+  return result;
+}
+
+void Log2Histogram::add(std::uint64_t value)
+{
+  std::size_t bucket = 0;
+  while (value != 0)
+  {
+    ++bucket;
+    value >>= 1;
+  }
+  ++counts_[bucket];
+}
+
+void Log2Histogram::merge(const Log2Histogram& other)
+{
+  for (std::size_t i = 0; i < kNumBuckets; ++i)
+  {
+    counts_[i] += other.counts_[i];
+  }
+}
+
+std::uint64_t Log2Histogram::lower_bound(std::size_t bucket)
+{
+  return bucket == 0 ? 0 : std::uint64_t{1} << (bucket - 1);
+}
+
+} // namespace jwt
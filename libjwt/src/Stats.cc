@@ -0,0 +1,255 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "libjwt/Stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include "libjwt/config.h"
+
+#if defined(JWT_OS_WIN)
+#  include <windows.h>
+#  include <psapi.h>
+#  pragma comment(lib, "psapi.lib")
+#else
+#  include <sys/resource.h>
+#endif
+
+namespace jwt {
+
+namespace {
+
+std::atomic<Stats*> g_stats {nullptr};
+
+std::size_t index_of(Phase phase)
+{
+  return static_cast<std::size_t>(phase);
+}
+
+double seconds(std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+
+} // anonymous namespace
+
+const char* phase_name(Phase phase)
+{
+  switch (phase)
+  {
+    case Phase::Read: return "read";
+    case Phase::Split: return "split";
+    case Phase::Base64Decode: return "base64";
+    case Phase::JsonParse: return "json";
+    case Phase::Print: return "print";
+    case Phase::Write: return "write";
+    case Phase::Flush: return "flush";
+  }
+  return "unknown";
+}
+
+void Stats::record(Phase phase, std::chrono::nanoseconds elapsed, std::uint64_t bytes, AllocationCount allocations)
+{
+  auto& counters = phases_[index_of(phase)];
+  counters.nanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+  counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  counters.count.fetch_add(1, std::memory_order_relaxed);
+  counters.allocation_count.fetch_add(allocations.count, std::memory_order_relaxed);
+  counters.allocation_bytes.fetch_add(allocations.bytes, std::memory_order_relaxed);
+}
+
+void Stats::record_token()
+{
+  tokens_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats::record_error(JwtError::Code code)
+{
+  errors_[static_cast<std::size_t>(code)].fetch_add(1, std::memory_order_relaxed);
+}
+
+Stats::PhaseTotals Stats::totals(Phase phase) const
+{
+  auto& counters = phases_[index_of(phase)];
+  return PhaseTotals{
+    std::chrono::nanoseconds{counters.nanoseconds.load(std::memory_order_relaxed)},
+    counters.bytes.load(std::memory_order_relaxed),
+    counters.count.load(std::memory_order_relaxed),
+    AllocationCount{
+      counters.allocation_count.load(std::memory_order_relaxed),
+      counters.allocation_bytes.load(std::memory_order_relaxed)
+    }
+  };
+}
+
+std::uint64_t Stats::tokens() const
+{
+  return tokens_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Stats::errors(JwtError::Code code) const
+{
+  return errors_[static_cast<std::size_t>(code)].load(std::memory_order_relaxed);
+}
+
+void Stats::print_summary(std::ostream& os, std::chrono::nanoseconds wall_time) const
+{
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+
+  auto wall = seconds(wall_time);
+  os << "wall time:   " << wall << " s" << '\n';
+  os << "tokens:      " << tokens();
+  if (wall > 0)
+  {
+    os << " (" << std::setprecision(0) << tokens() / wall << " tokens/s)" << std::setprecision(3);
+  }
+  os << '\n';
+  os << "errors:      " << errors(JwtError::Code::SegmentCount) << " segment count, "
+     << errors(JwtError::Code::Base64) << " base64, "
+     << errors(JwtError::Code::Json) << " json" << '\n';
+  os << "peak RSS:    " << peak_rss_bytes() / (1024.0 * 1024.0) << " MiB" << '\n';
+
+  if (kCountsAllocations)
+  {
+    // Only the phases libjwt runs once per token say anything about a token.
+    AllocationCount per_token;
+    for (auto phase : {Phase::Split, Phase::Base64Decode, Phase::JsonParse, Phase::Print})
+    {
+      per_token.count += totals(phase).allocations.count;
+      per_token.bytes += totals(phase).allocations.bytes;
+    }
+
+    auto num_tokens = std::max<std::uint64_t>(tokens(), 1);
+    os << "allocations: " << std::setprecision(1)
+       << static_cast<double>(per_token.count) / num_tokens << " per token, "
+       << static_cast<double>(per_token.bytes) / num_tokens << " bytes per token"
+       << std::setprecision(3) << '\n';
+  }
+
+  os << std::left << std::setw(8) << "phase" << std::right
+     << std::setw(12) << "time (s)"
+     << std::setw(8) << "share"
+     << std::setw(12) << "calls"
+     << std::setw(16) << "bytes"
+     << std::setw(12) << "MiB/s";
+  if (kCountsAllocations)
+  {
+    os << std::setw(12) << "allocs" << std::setw(16) << "alloc bytes";
+  }
+  os << '\n';
+
+  for (std::size_t i = 0; i < kNumPhases; ++i)
+  {
+    auto phase = static_cast<Phase>(i);
+    auto t = totals(phase);
+    auto elapsed = seconds(t.elapsed);
+
+    os << std::left << std::setw(8) << phase_name(phase) << std::right
+       << std::setw(12) << elapsed
+       << std::setw(7) << std::setprecision(1) << (wall > 0 ? 100 * elapsed / wall : 0.0) << '%'
+       << std::setw(12) << t.count
+       << std::setw(16) << t.bytes
+       << std::setw(12) << (elapsed > 0 ? t.bytes / elapsed / (1024 * 1024) : 0.0)
+       << std::setprecision(3);
+    if (kCountsAllocations)
+    {
+      os << std::setw(12) << t.allocations.count << std::setw(16) << t.allocations.bytes;
+    }
+    os << '\n';
+  }
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void set_stats(Stats* stats)
+{
+  g_stats.store(stats, std::memory_order_release);
+}
+
+Stats* current_stats()
+{
+  return g_stats.load(std::memory_order_acquire);
+}
+
+std::uint64_t peak_rss_bytes()
+{
+#if defined(JWT_OS_WIN)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return counters.PeakWorkingSetSize;
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+#  if defined(__APPLE__)
+  return static_cast<std::uint64_t>(usage.ru_maxrss);
+#  else
+  return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#  endif
+#endif
+}
+
+ScopedPhase::ScopedPhase(Phase phase, std::uint64_t bytes)
+    : stats_(current_stats())
+    , trace_(current_trace())
+    , phase_(phase)
+    , bytes_(bytes)
+{
+  if (stats_ != nullptr)
+  {
+    start_allocations_ = thread_allocations();
+  }
+  if (stats_ != nullptr || trace_ != nullptr)
+  {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+ScopedPhase::~ScopedPhase()
+{
+  if (stats_ == nullptr && trace_ == nullptr)
+  {
+    return;
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  if (stats_ != nullptr)
+  {
+    auto allocations = thread_allocations();
+    stats_->record(phase_, end - start_, bytes_, AllocationCount{
+      allocations.count - start_allocations_.count,
+      allocations.bytes - start_allocations_.bytes
+    });
+  }
+  if (trace_ != nullptr)
+  {
+    trace_->record(phase_name(phase_), start_, end);
+  }
+}
+
+} // namespace jwt
@@ -0,0 +1,416 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/Tape.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace jwt {
+
+namespace {
+
+constexpr std::uint64_t kPayloadMask = 0x00FFFFFFFFFFFFFFull;
+
+constexpr std::uint64_t make_word(Tape::Type type, std::uint64_t payload)
+{
+  return (static_cast<std::uint64_t>(type) << 56) | (payload & kPayloadMask);
+}
+
+} // anonymous namespace
+
+// Writes values onto the end of a tape.  It is driven either by visiting an
+// existing ordered_json, or directly by nlohmann's SAX parser so that no
+// intermediate DOM is built.
+class TapeBuilder : public IJsonVisitor
+{
+public:
+  explicit TapeBuilder(Tape& tape)
+    : tape_(tape.tape_)
+    , strings_(tape.strings_)
+    , open_(tape.open_containers_)
+  {}
+
+  virtual void on_object_start() override
+  {
+    open_container(Tape::Type::ObjectStart);
+  }
+
+  virtual void on_object_field_name(const std::string& name) override
+  {
+    write_string(Tape::Type::Key, name);
+  }
+
+  virtual void on_object_end() override
+  {
+    close_container(Tape::Type::ObjectEnd);
+  }
+
+  virtual void on_array_start() override
+  {
+    open_container(Tape::Type::ArrayStart);
+  }
+
+  virtual void on_array_end() override
+  {
+    close_container(Tape::Type::ArrayEnd);
+  }
+
+  virtual void on_null() override
+  {
+    tape_.push_back(make_word(Tape::Type::Null, 0));
+  }
+
+  virtual void on_string(const std::string& value) override
+  {
+    write_string(Tape::Type::String, value);
+  }
+
+  virtual void on_signed_number(std::int64_t value) override
+  {
+    tape_.push_back(make_word(Tape::Type::SignedNumber, 0));
+    tape_.push_back(static_cast<std::uint64_t>(value));
+  }
+
+  virtual void on_unsigned_number(std::uint64_t value) override
+  {
+    tape_.push_back(make_word(Tape::Type::UnsignedNumber, 0));
+    tape_.push_back(value);
+  }
+
+  virtual void on_floating_point_number(double value) override
+  {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    tape_.push_back(make_word(Tape::Type::FloatingPointNumber, 0));
+    tape_.push_back(bits);
+  }
+
+  virtual void on_boolean(bool value) override
+  {
+    tape_.push_back(make_word(value ? Tape::Type::True : Tape::Type::False, 0));
+  }
+
+  // nlohmann::json_sax interface
+
+  bool null()
+  {
+    on_null();
+    return true;
+  }
+
+  bool boolean(bool value)
+  {
+    on_boolean(value);
+    return true;
+  }
+
+  bool number_integer(ordered_json::number_integer_t value)
+  {
+    on_signed_number(value);
+    return true;
+  }
+
+  bool number_unsigned(ordered_json::number_unsigned_t value)
+  {
+    on_unsigned_number(value);
+    return true;
+  }
+
+  bool number_float(ordered_json::number_float_t value, const ordered_json::string_t&)
+  {
+    on_floating_point_number(value);
+    return true;
+  }
+
+  bool string(ordered_json::string_t& value)
+  {
+    on_string(value);
+    return true;
+  }
+
+  bool binary(ordered_json::binary_t&)
+  {
+    // Only reachable when parsing binary formats, which we never do.
+    return false;
+  }
+
+  bool start_object(std::size_t)
+  {
+    on_object_start();
+    return true;
+  }
+
+  bool key(ordered_json::string_t& name)
+  {
+    on_object_field_name(name);
+    return true;
+  }
+
+  bool end_object()
+  {
+    on_object_end();
+    return true;
+  }
+
+  bool start_array(std::size_t)
+  {
+    on_array_start();
+    return true;
+  }
+
+  bool end_array()
+  {
+    on_array_end();
+    return true;
+  }
+
+  template <typename Exception>
+  bool parse_error(std::size_t, const std::string&, const Exception& ex)
+  {
+    throw ex;
+  }
+
+private:
+  void open_container(Tape::Type type)
+  {
+    open_.push_back(tape_.size());
+    tape_.push_back(make_word(type, 0));
+  }
+
+  void close_container(Tape::Type type)
+  {
+    assert(!open_.empty());
+
+    auto start = open_.back();
+    open_.pop_back();
+
+    tape_.push_back(make_word(type, start));
+    tape_[start] = make_word(static_cast<Tape::Type>(tape_[start] >> 56), tape_.size());
+  }
+
+  void write_string(Tape::Type type, const std::string& value)
+  {
+    if (value.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+      throw std::length_error{"string too long for tape"};
+    }
+
+    auto offset = strings_.size();
+    auto length = static_cast<std::uint32_t>(value.size());
+
+    strings_.resize(offset + sizeof(length) + value.size());
+    std::memcpy(strings_.data() + offset, &length, sizeof(length));
+    std::memcpy(strings_.data() + offset + sizeof(length), value.data(), value.size());
+
+    tape_.push_back(make_word(type, offset));
+  }
+
+  std::vector<std::uint64_t>& tape_;
+  std::vector<char>& strings_;
+  std::vector<std::size_t>& open_;
+};
+
+std::size_t Tape::parse(std::string_view json)
+{
+  auto root = tape_.size();
+  auto strings_size = strings_.size();
+
+  TapeBuilder builder{*this};
+  try
+  {
+    ordered_json::sax_parse(json.begin(), json.end(), &builder);
+  }
+  catch (...)
+  {
+    tape_.resize(root);
+    strings_.resize(strings_size);
+    open_containers_.clear();
+    throw;
+  }
+
+  return root;
+}
+
+std::size_t Tape::append(const ordered_json& json)
+{
+  auto root = tape_.size();
+
+  TapeBuilder builder{*this};
+  visit(json, builder);
+
+  return root;
+}
+
+void Tape::clear()
+{
+  tape_.clear();
+  strings_.clear();
+  open_containers_.clear();
+}
+
+Tape::Type Tape::type(std::size_t index) const
+{
+  return static_cast<Type>(tape_[index] >> 56);
+}
+
+std::size_t Tape::next(std::size_t index) const
+{
+  switch (type(index))
+  {
+    case Type::ObjectStart:
+    case Type::ArrayStart:
+      return static_cast<std::size_t>(tape_[index] & kPayloadMask);
+
+    case Type::SignedNumber:
+    case Type::UnsignedNumber:
+    case Type::FloatingPointNumber:
+      return index + 2;
+
+    default:
+      return index + 1;
+  }
+}
+
+std::string_view Tape::get_string(std::size_t index) const
+{
+  assert(type(index) == Type::String || type(index) == Type::Key);
+
+  auto offset = static_cast<std::size_t>(tape_[index] & kPayloadMask);
+
+  std::uint32_t length;
+  std::memcpy(&length, strings_.data() + offset, sizeof(length));
+
+  return std::string_view{strings_.data() + offset + sizeof(length), length};
+}
+
+std::int64_t Tape::get_signed(std::size_t index) const
+{
+  assert(type(index) == Type::SignedNumber);
+  return static_cast<std::int64_t>(tape_[index + 1]);
+}
+
+std::uint64_t Tape::get_unsigned(std::size_t index) const
+{
+  assert(type(index) == Type::UnsignedNumber);
+  return tape_[index + 1];
+}
+
+double Tape::get_double(std::size_t index) const
+{
+  assert(type(index) == Type::FloatingPointNumber);
+
+  double value;
+  std::memcpy(&value, &tape_[index + 1], sizeof(value));
+  return value;
+}
+
+std::size_t Tape::find(std::size_t object, std::string_view key) const
+{
+  if (type(object) != Type::ObjectStart)
+  {
+    return npos;
+  }
+
+  auto i = object + 1;
+  while (type(i) == Type::Key)
+  {
+    if (get_string(i) == key)
+    {
+      return i + 1;
+    }
+    i = next(i + 1);
+  }
+
+  return npos;
+}
+
+void visit(const Tape& tape, std::size_t root, IJsonVisitor& visitor)
+{
+  // The visitor interface takes std::strings; reuse one buffer for all of them.
+  std::string text;
+
+  auto end = tape.next(root);
+  for (auto i = root; i < end;)
+  {
+    auto type = tape.type(i);
+    switch (type)
+    {
+      case Tape::Type::ObjectStart:
+        visitor.on_object_start();
+        break;
+
+      case Tape::Type::ObjectEnd:
+        visitor.on_object_end();
+        break;
+
+      case Tape::Type::ArrayStart:
+        visitor.on_array_start();
+        break;
+
+      case Tape::Type::ArrayEnd:
+        visitor.on_array_end();
+        break;
+
+      case Tape::Type::Key:
+        text.assign(tape.get_string(i));
+        visitor.on_object_field_name(text);
+        break;
+
+      case Tape::Type::String:
+        text.assign(tape.get_string(i));
+        visitor.on_string(text);
+        break;
+
+      case Tape::Type::SignedNumber:
+        visitor.on_signed_number(tape.get_signed(i));
+        break;
+
+      case Tape::Type::UnsignedNumber:
+        visitor.on_unsigned_number(tape.get_unsigned(i));
+        break;
+
+      case Tape::Type::FloatingPointNumber:
+        visitor.on_floating_point_number(tape.get_double(i));
+        break;
+
+      case Tape::Type::True:
+        visitor.on_boolean(true);
+        break;
+
+      case Tape::Type::False:
+        visitor.on_boolean(false);
+        break;
+
+      case Tape::Type::Null:
+        visitor.on_null();
+        break;
+
+      default:
+        abort();
+    }
+
+    // Step into containers rather than over them.
+    i = type == Tape::Type::ObjectStart || type == Tape::Type::ArrayStart ? i + 1 : tape.next(i);
+  }
+}
+
+} // namespace jwt
@@ -0,0 +1,180 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/TimeHistogram.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "Claims.h"
+
+namespace jwt {
+
+namespace {
+
+std::int64_t floor_div(std::int64_t a, std::int64_t b)
+{
+  auto quotient = a / b;
+  return (a % b != 0 && (a < 0) != (b < 0)) ? quotient - 1 : quotient;
+}
+
+} // anonymous namespace
+
+TimeHistogram::TimeHistogram(std::int64_t bucket_seconds)
+  : bucket_seconds_(bucket_seconds)
+{
+  if (bucket_seconds <= 0)
+  {
+    throw std::invalid_argument("Histogram buckets must be at least a second wide");
+  }
+}
+
+std::int64_t TimeHistogram::bucket_of(std::int64_t seconds) const
+{
+  return floor_div(seconds, bucket_seconds_) * bucket_seconds_;
+}
+
+void TimeHistogram::add(const Jwt& token)
+{
+  // A JWE's claims are in its ciphertext, so find_claim() finds nothing.
+  const auto& payload = token.payload();
+
+  std::int64_t issued_at;
+  std::int64_t expires_at;
+  bool has_issued_at = get_seconds(payload, "iat", issued_at);
+  bool has_expires_at = get_seconds(payload, "exp", expires_at);
+  if (!has_issued_at && !has_expires_at)
+  {
+    ++untimed_;
+    return;
+  }
+
+  // Look up by the claim's own string, so that only new issuers are copied.
+  static const std::string kNoIssuer;
+  std::string scratch;
+  auto* issuer = find_claim(payload, "iss");
+  const auto& key = issuer == nullptr ? kNoIssuer
+      : issuer->is_string() ? issuer->get_ref<const std::string&>()
+      : (scratch = issuer->dump());
+
+  auto it = issuers_.find(key);
+  if (it == issuers_.end())
+  {
+    it = issuers_.emplace(key, Buckets{}).first;
+  }
+
+  auto& buckets = it->second;
+  if (has_issued_at)
+  {
+    ++buckets[bucket_of(issued_at)].issued;
+  }
+  if (has_expires_at)
+  {
+    ++buckets[bucket_of(expires_at)].expiring;
+  }
+}
+
+void TimeHistogram::merge(const TimeHistogram& other)
+{
+  if (other.bucket_seconds_ != bucket_seconds_)
+  {
+    throw std::invalid_argument("Cannot merge histograms with different buckets");
+  }
+
+  for (const auto& [issuer, other_buckets] : other.issuers_)
+  {
+    auto& buckets = issuers_[issuer];
+    for (const auto& [start, counts] : other_buckets)
+    {
+      auto& total = buckets[start];
+      total.issued += counts.issued;
+      total.expiring += counts.expiring;
+    }
+  }
+
+  untimed_ += other.untimed_;
+}
+
+ordered_json TimeHistogram::to_json() const
+{
+  struct Row
+  {
+    std::int64_t start;
+    const std::string* issuer;
+    Counts counts;
+  };
+
+  std::vector<Row> rows;
+  for (const auto& [issuer, buckets] : issuers_)
+  {
+    for (const auto& [start, counts] : buckets)
+    {
+      rows.push_back(Row{start, &issuer, counts});
+    }
+  }
+
+  std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+    return std::tie(a.start, *a.issuer) < std::tie(b.start, *b.issuer);
+  });
+
+  auto json_rows = ordered_json::array();
+  for (const auto& row : rows)
+  {
+    ordered_json json_row;
+    json_row["time"] = format_utc(row.start);
+    json_row["iss"] = row.issuer->empty() ? ordered_json() : ordered_json(*row.issuer);
+    json_row["issued"] = row.counts.issued;
+    json_row["expiring"] = row.counts.expiring;
+    json_rows.push_back(std::move(json_row));
+  }
+
+  ordered_json json;
+  json["bucket_seconds"] = bucket_seconds_;
+  json["untimed"] = untimed_;
+  json["buckets"] = std::move(json_rows);
+  return json;
+}
+
+std::string format_utc(std::int64_t seconds)
+{
+  auto days = floor_div(seconds, TimeHistogram::kDay);
+  auto time_of_day = seconds - days * TimeHistogram::kDay;
+
+  // Howard Hinnant's civil_from_days, counting in 400-year eras from
+  // 0000-03-01 so that leap days fall at the end of each year.
+  auto z = days + 719468;
+  auto era = floor_div(z, 146097);
+  auto day_of_era = z - era * 146097;
+  auto year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  auto day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  auto month_index = (5 * day_of_year + 2) / 153;
+  auto day = day_of_year - (153 * month_index + 2) / 5 + 1;
+  auto month = month_index < 10 ? month_index + 3 : month_index - 9;
+  auto year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "%04lld-%02d-%02dT%02d:%02d:%02dZ",
+                static_cast<long long>(year), static_cast<int>(month), static_cast<int>(day),
+                static_cast<int>(time_of_day / 3600), static_cast<int>(time_of_day / 60 % 60),
+                static_cast<int>(time_of_day % 60));
+  return buffer;
+}
+
+} // namespace jwt
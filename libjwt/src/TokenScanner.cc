@@ -0,0 +1,218 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/TokenScanner.h"
+
+#include <algorithm>
+#include <array>
+
+#include "libjwt/config.h"
+
+#if defined(JWT_HAVE_SSE2)
+#  include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace jwt {
+
+namespace {
+
+constexpr std::array<bool, 256> make_token_chars()
+{
+  std::array<bool, 256> table {};
+  for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+  for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+  for (int c = '0'; c <= '9'; ++c) table[c] = true;
+  table['-'] = true;
+  table['_'] = true;
+  return table;
+}
+
+constexpr std::array<bool, 256> kTokenChars = make_token_chars();
+
+bool is_token_char(char c)
+{
+  return kTokenChars[static_cast<unsigned char>(c)];
+}
+
+bool is_boundary(char c)
+{
+  return !is_token_char(c) && c != '.';
+}
+
+#if defined(JWT_HAVE_SSE2)
+
+unsigned count_trailing_zeros(unsigned mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// Returns a mask with one bit set per byte of `chunk` in the base64url alphabet.
+unsigned token_char_mask(__m128i chunk)
+{
+  // Setting 0x20 folds 'A'-'Z' onto 'a'-'z' without letting anything else in.
+  auto folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+  auto letter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                              _mm_cmplt_epi8(folded, _mm_set1_epi8('z' + 1)));
+  auto digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+                             _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+  auto symbol = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('-')),
+                             _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+
+  return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), symbol)));
+}
+
+#endif
+
+// Returns the index of the first "eyJ" at or after `i`, or `size` if there is none.
+std::size_t find_prefix(const char* data, std::size_t i, std::size_t size)
+{
+#if defined(JWT_HAVE_SSE2)
+  const auto e = _mm_set1_epi8('e');
+  const auto y = _mm_set1_epi8('y');
+  const auto J = _mm_set1_epi8('J');
+
+  for (; i + 18 <= size; i += 16)
+  {
+    auto first = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), e);
+    auto second = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1)), y);
+    auto third = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 2)), J);
+
+    auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(first, second), third)));
+    if (mask != 0)
+    {
+      return i + count_trailing_zeros(mask);
+    }
+  }
+#endif
+
+  for (; i + 3 <= size; ++i)
+  {
+    if (data[i] == 'e' && data[i + 1] == 'y' && data[i + 2] == 'J')
+    {
+      return i;
+    }
+  }
+
+  return size;
+}
+
+// Returns the index of the first byte at or after `i` that is not in the
+// base64url alphabet, or `size` if there is none.
+std::size_t skip_token_chars(const char* data, std::size_t i, std::size_t size)
+{
+#if defined(JWT_HAVE_SSE2)
+  for (; i + 16 <= size; i += 16)
+  {
+    auto mask = token_char_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    if (mask != 0xFFFF)
+    {
+      return i + count_trailing_zeros(~mask);
+    }
+  }
+#endif
+
+  while (i < size && is_token_char(data[i]))
+  {
+    ++i;
+  }
+
+  return i;
+}
+
+} // anonymous namespace
+
+std::size_t TokenScanner::scan(std::string_view buffer, bool end_of_input, const Callback& on_token)
+{
+  const char* data = buffer.data();
+  const auto size = buffer.size();
+
+  std::size_t consumed = 0;
+  std::size_t pos = 0;
+  while (true)
+  {
+    auto start = find_prefix(data, pos, size);
+    if (start == size)
+    {
+      // Hold back a trailing "e" or "ey" that the next buffer might complete.
+      consumed = end_of_input ? size : std::max(pos, size - std::min<std::size_t>(size, 2));
+      break;
+    }
+
+    auto before = start > 0 ? data[start - 1] : previous_;
+    if (!is_boundary(before))
+    {
+      pos = start + 3;
+      continue;
+    }
+
+    std::size_t segments = 1;
+    auto end = skip_token_chars(data, start + 3, size);
+    while (end < size && data[end] == '.')
+    {
+      ++segments;
+      end = skip_token_chars(data, end + 1, size);
+    }
+
+    if (end == size && !end_of_input)
+    {
+      // The run might continue in the next buffer.
+      consumed = start;
+      break;
+    }
+
+    // A token at the end of a sentence picks up a trailing period.
+    auto token_end = end;
+    if (data[token_end - 1] == '.' && (segments == 4 || segments == 6))
+    {
+      --token_end;
+      --segments;
+    }
+
+    if (segments == 3 || segments == 5)
+    {
+      on_token(std::string_view{data + start, token_end - start}, offset_ + start);
+    }
+
+    pos = end;
+  }
+
+  if (consumed > 0)
+  {
+    offset_ += consumed;
+    previous_ = data[consumed - 1];
+  }
+
+  return consumed;
+}
+
+void find_tokens(std::string_view text, const TokenScanner::Callback& on_token)
+{
+  TokenScanner scanner;
+  scanner.scan(text, true, on_token);
+}
+
+} // namespace jwt
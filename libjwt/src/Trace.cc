@@ -0,0 +1,176 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libjwt/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+
+#include "libjwt/JsonVisitor.h"
+
+namespace jwt {
+
+namespace {
+
+std::atomic<Trace*> g_trace {nullptr};
+std::atomic<std::uint64_t> g_next_trace_id {1};
+
+// The buffer this thread last used, tagged with its Trace's id rather than
+// its address, which a later Trace could reuse.
+struct ThreadSlot
+{
+  std::uint64_t trace_id {0};
+  void* buffer {nullptr};
+};
+
+thread_local ThreadSlot t_slot;
+
+constexpr std::size_t kInitialEvents = 1024;
+
+} // anonymous namespace
+
+Trace::Trace(std::size_t events_per_thread)
+    : id_(g_next_trace_id.fetch_add(1, std::memory_order_relaxed))
+    , events_per_thread_(events_per_thread > 0 ? events_per_thread : 1)
+    , origin_(Clock::now())
+{}
+
+Trace::~Trace() = default;
+
+Trace::ThreadBuffer& Trace::thread_buffer()
+{
+  if (t_slot.trace_id == id_)
+  {
+    return *static_cast<ThreadBuffer*>(t_slot.buffer);
+  }
+
+  // Most threads record far fewer events than they could keep, so buffers
+  // start small and grow as needed.
+  auto buffer = std::make_unique<ThreadBuffer>();
+  buffer->events.reserve(std::min<std::size_t>(events_per_thread_, kInitialEvents));
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  buffer->name = "thread " + std::to_string(threads_.size() + 1);
+  threads_.push_back(std::move(buffer));
+
+  t_slot = ThreadSlot{id_, threads_.back().get()};
+  return *threads_.back();
+}
+
+void Trace::record(const char* name, Clock::time_point start, Clock::time_point end)
+{
+  auto& buffer = thread_buffer();
+  Event event {
+    name,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count(),
+    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+  };
+  if (buffer.events.size() < events_per_thread_)
+  {
+    buffer.events.push_back(event);
+  }
+  else
+  {
+    buffer.events[buffer.recorded % buffer.events.size()] = event;
+  }
+  ++buffer.recorded;
+}
+
+void Trace::set_thread_name(std::string name)
+{
+  auto& buffer = thread_buffer();
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  buffer.name = std::move(name);
+}
+
+void Trace::write(std::ostream& os) const
+{
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+
+  // Span names are literals, so only thread names need escaping.
+  os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+  const char* separator = "\n";
+  for (std::size_t i = 0; i < threads_.size(); ++i)
+  {
+    const auto& buffer = *threads_[i];
+    const auto tid = i + 1;
+
+    os << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+       << ",\"args\":{\"name\":" << ordered_json(buffer.name).dump() << "}}";
+    separator = ",\n";
+
+    const auto capacity = buffer.events.size();
+    const auto dropped = buffer.recorded > capacity ? buffer.recorded - capacity : 0;
+    if (dropped > 0)
+    {
+      os << separator << "{\"name\":\"dropped_events\",\"ph\":\"C\",\"ts\":0,\"pid\":1,\"tid\":" << tid
+         << ",\"args\":{\"count\":" << dropped << "}}";
+    }
+
+    // Oldest first, so that viewers need not sort.
+    for (auto n = dropped; n < buffer.recorded; ++n)
+    {
+      const auto& event = buffer.events[n % capacity];
+      os << separator << "{\"name\":\"" << event.name << "\",\"cat\":\"jwt\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+         << ",\"ts\":" << event.start_ns / 1000.0 << ",\"dur\":" << event.duration_ns / 1000.0 << "}";
+    }
+  }
+
+  os << "\n]}\n";
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void set_trace(Trace* trace)
+{
+  g_trace.store(trace, std::memory_order_release);
+}
+
+Trace* current_trace()
+{
+  return g_trace.load(std::memory_order_acquire);
+}
+
+ScopedSpan::ScopedSpan(const char* name)
+    : trace_(current_trace())
+    , name_(name)
+{
+  if (trace_ != nullptr)
+  {
+    start_ = Trace::Clock::now();
+  }
+}
+
+ScopedSpan::~ScopedSpan()
+{
+  if (trace_ != nullptr)
+  {
+    trace_->record(name_, start_, Trace::Clock::now());
+  }
+}
+
+} // namespace jwt
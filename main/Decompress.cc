@@ -0,0 +1,396 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Decompress.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "libjwt/InputError.h"
+#include "libjwt/Trace.h"
+
+#include "SpscQueue.h"
+
+#if defined(JWT_HAVE_ZLIB)
+#  include <zlib.h>
+#endif
+
+#if defined(JWT_HAVE_ZSTD)
+#  include <zstd.h>
+#endif
+
+namespace {
+
+constexpr std::size_t kWindowSize = 1 << 20;
+constexpr std::size_t kWindowsAhead = 4;
+constexpr std::size_t kCompressedChunkSize = 256 * 1024;
+
+// Decompresses one stream, one call at a time.
+class Codec
+{
+public:
+  Codec(std::unique_ptr<InputSource> compressed, std::string prefix)
+      : compressed_(std::move(compressed))
+      , input_(std::move(prefix))
+  {}
+
+  virtual ~Codec() = default;
+
+  // Fills up to `size` bytes, returning 0 only at the end of the stream.
+  virtual std::size_t fill(char* out, std::size_t size) = 0;
+
+protected:
+  // Makes sure there is compressed input unless the source is exhausted.
+  // Returns false at its end.
+  bool refill()
+  {
+    if (input_pos_ < input_.size())
+    {
+      return true;
+    }
+
+    input_.resize(kCompressedChunkSize);
+    input_.resize(compressed_->read(input_.data(), input_.size()));
+    input_pos_ = 0;
+    return !input_.empty();
+  }
+
+  std::unique_ptr<InputSource> compressed_;
+  std::string input_;
+  std::size_t input_pos_ {0};
+};
+
+#if defined(JWT_HAVE_ZLIB)
+
+class GzipCodec : public Codec
+{
+public:
+  GzipCodec(std::unique_ptr<InputSource> compressed, std::string prefix)
+      : Codec(std::move(compressed), std::move(prefix))
+  {
+    std::memset(&stream_, 0, sizeof(stream_));
+    // 32 asks zlib to accept either a gzip or a zlib header.
+    if (inflateInit2(&stream_, 15 + 32) != Z_OK)
+    {
+      throw jwt::InputError{"Could not initialize zlib"};
+    }
+  }
+
+  ~GzipCodec() override
+  {
+    inflateEnd(&stream_);
+  }
+
+  std::size_t fill(char* out, std::size_t size) override
+  {
+    stream_.next_out = reinterpret_cast<Bytef*>(out);
+    stream_.avail_out = static_cast<uInt>(size);
+
+    while (stream_.avail_out > 0 && !finished_)
+    {
+      bool have_input = refill();
+      if (!have_input && at_member_start_)
+      {
+        finished_ = true;
+        break;
+      }
+
+      // Even without new input, zlib may hold output that did not fit last time.
+      stream_.next_in = reinterpret_cast<Bytef*>(input_.data() + input_pos_);
+      stream_.avail_in = static_cast<uInt>(input_.size() - input_pos_);
+      auto avail_out = stream_.avail_out;
+
+      int rc = inflate(&stream_, Z_NO_FLUSH);
+      input_pos_ = input_.size() - stream_.avail_in;
+      at_member_start_ = false;
+
+      if (rc == Z_STREAM_END)
+      {
+        // Rotated logs are often several gzip members back to back.
+        inflateReset(&stream_);
+        at_member_start_ = true;
+      }
+      else if (rc != Z_OK && rc != Z_BUF_ERROR)
+      {
+        throw jwt::InputError{std::string{"Corrupt gzip input: "} + (stream_.msg != nullptr ? stream_.msg : "unknown error")};
+      }
+      else if (!have_input && stream_.avail_out == avail_out)
+      {
+        throw jwt::InputError{"Truncated gzip input"};
+      }
+    }
+
+    return size - stream_.avail_out;
+  }
+
+private:
+  z_stream stream_;
+  bool at_member_start_ {true};
+  bool finished_ {false};
+};
+
+#endif
+
+#if defined(JWT_HAVE_ZSTD)
+
+class ZstdCodec : public Codec
+{
+public:
+  ZstdCodec(std::unique_ptr<InputSource> compressed, std::string prefix)
+      : Codec(std::move(compressed), std::move(prefix))
+      , stream_(ZSTD_createDStream())
+  {
+    if (stream_ == nullptr)
+    {
+      throw jwt::InputError{"Could not initialize zstd"};
+    }
+  }
+
+  ~ZstdCodec() override
+  {
+    ZSTD_freeDStream(stream_);
+  }
+
+  std::size_t fill(char* out, std::size_t size) override
+  {
+    ZSTD_outBuffer output {out, size, 0};
+
+    while (output.pos < output.size && !finished_)
+    {
+      bool have_input = refill();
+      if (!have_input && frame_remaining_ == 0)
+      {
+        finished_ = true;
+        break;
+      }
+
+      // Even without new input, zstd may hold output that did not fit last time.
+      ZSTD_inBuffer input {input_.data(), input_.size(), input_pos_};
+      auto out_pos = output.pos;
+
+      frame_remaining_ = ZSTD_decompressStream(stream_, &output, &input);
+      input_pos_ = input.pos;
+
+      if (ZSTD_isError(frame_remaining_))
+      {
+        throw jwt::InputError{std::string{"Corrupt zstd input: "} + ZSTD_getErrorName(frame_remaining_)};
+      }
+      if (!have_input && frame_remaining_ != 0 && output.pos == out_pos)
+      {
+        throw jwt::InputError{"Truncated zstd input"};
+      }
+    }
+
+    return output.pos;
+  }
+
+private:
+  ZSTD_DStream* stream_;
+  std::size_t frame_remaining_ {0};
+  bool finished_ {false};
+};
+
+#endif
+
+std::unique_ptr<Codec> make_codec(Compression compression, std::unique_ptr<InputSource> compressed, std::string prefix)
+{
+  switch (compression)
+  {
+    case Compression::Gzip:
+#if defined(JWT_HAVE_ZLIB)
+      return std::make_unique<GzipCodec>(std::move(compressed), std::move(prefix));
+#else
+      throw jwt::InputError{"gzip input is not supported by this build of jwt_dump"};
+#endif
+
+    case Compression::Zstd:
+#if defined(JWT_HAVE_ZSTD)
+      return std::make_unique<ZstdCodec>(std::move(compressed), std::move(prefix));
+#else
+      throw jwt::InputError{"zstd input is not supported by this build of jwt_dump"};
+#endif
+
+    case Compression::None:
+      break;
+  }
+  return nullptr;
+}
+
+// Runs a codec on a background thread, handing windows of output to read().
+class DecompressingSource : public InputSource
+{
+public:
+  explicit DecompressingSource(std::unique_ptr<Codec> codec)
+      : codec_(std::move(codec))
+      , filled_(kWindowsAhead)
+      , empty_(kWindowsAhead + 1)
+  {
+    for (std::size_t i = 0; i < kWindowsAhead + 1; ++i)
+    {
+      auto window = std::make_unique<Window>();
+      window->data.resize(kWindowSize);
+      empty_.push(std::move(window));
+    }
+
+    thread_ = std::thread{&DecompressingSource::decompress, this};
+  }
+
+  ~DecompressingSource() override
+  {
+    // Drain until the thread has said its last word, so it can be joined.
+    stop_.store(true, std::memory_order_relaxed);
+    while (!done_)
+    {
+      next_window();
+    }
+    thread_.join();
+  }
+
+  std::size_t read(char* buffer, std::size_t size) override
+  {
+    while (!current_ || current_pos_ == current_->size)
+    {
+      if (done_)
+      {
+        return 0;
+      }
+      next_window();
+    }
+
+    auto n = std::min(size, current_->size - current_pos_);
+    std::memcpy(buffer, current_->data.data() + current_pos_, n);
+    current_pos_ += n;
+    return n;
+  }
+
+private:
+  struct Window
+  {
+    std::vector<char> data;
+    std::size_t size {0};
+    std::exception_ptr error;
+  };
+
+  void next_window()
+  {
+    if (current_)
+    {
+      empty_.push(std::move(current_));
+    }
+
+    current_ = filled_.pop();
+    current_pos_ = 0;
+    if (current_->size == 0)
+    {
+      done_ = true;
+      if (current_->error && !stop_.load(std::memory_order_relaxed))
+      {
+        std::rethrow_exception(current_->error);
+      }
+    }
+  }
+
+  void decompress()
+  {
+    if (auto* trace = jwt::current_trace())
+    {
+      trace->set_thread_name("decompress");
+    }
+
+    while (true)
+    {
+      auto window = empty_.pop();
+      window->size = 0;
+
+      if (!stop_.load(std::memory_order_relaxed))
+      {
+        try
+        {
+          jwt::ScopedSpan span{"decompress"};
+          window->size = codec_->fill(window->data.data(), window->data.size());
+        }
+        catch (...)
+        {
+          window->error = std::current_exception();
+        }
+      }
+
+      bool last = window->size == 0;
+      filled_.push(std::move(window));
+      if (last)
+      {
+        return;
+      }
+    }
+  }
+
+  std::unique_ptr<Codec> codec_;
+
+  SpscQueue<std::unique_ptr<Window>> filled_;
+  SpscQueue<std::unique_ptr<Window>> empty_;
+  std::atomic<bool> stop_ {false};
+  std::thread thread_;
+
+  // Reader side.
+  std::unique_ptr<Window> current_;
+  std::size_t current_pos_ {0};
+  bool done_ {false};
+};
+
+} // anonymous namespace
+
+Compression detect_compression(std::string_view magic)
+{
+  if (magic.size() >= 2 && magic[0] == '\x1f' && magic[1] == '\x8b')
+  {
+    return Compression::Gzip;
+  }
+  if (magic.size() >= 4 && magic.substr(0, 4) == std::string_view{"\x28\xb5\x2f\xfd", 4})
+  {
+    return Compression::Zstd;
+  }
+  return Compression::None;
+}
+
+Compression detect_file_compression(const std::string& path)
+{
+  FileSource source{path, ByteRange{0, 4}};
+  char magic[4];
+  std::size_t size = 0;
+  while (size < sizeof(magic))
+  {
+    auto n = source.read(magic + size, sizeof(magic) - size);
+    if (n == 0)
+    {
+      break;
+    }
+    size += n;
+  }
+  return detect_compression(std::string_view{magic, size});
+}
+
+std::unique_ptr<InputSource> open_decompressor(Compression compression,
+                                               std::unique_ptr<InputSource> compressed,
+                                               std::string prefix)
+{
+  return std::make_unique<DecompressingSource>(make_codec(compression, std::move(compressed), std::move(prefix)));
+}
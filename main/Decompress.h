@@ -0,0 +1,52 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_DECOMPRESS_H
+#define JWT_MAIN_DECOMPRESS_H
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "InputSource.h"
+
+enum class Compression
+{
+  None,
+  Gzip,
+  Zstd,
+};
+
+// Recognizes a compressed stream by its first four bytes.
+Compression detect_compression(std::string_view magic);
+
+// Whether the file at `path` starts like a compressed stream.
+Compression detect_file_compression(const std::string& path);
+
+// Wraps a compressed source in one that yields the decompressed bytes.
+//
+// Decompression runs on its own thread, a few fixed-size windows ahead of
+// the reader, so that it overlaps with scanning and decoding.  `prefix`
+// holds bytes already read from the front of `compressed`, e.g. to sniff its
+// format.  Throws InputError if support for `compression` was not built in.
+std::unique_ptr<InputSource> open_decompressor(Compression compression,
+                                               std::unique_ptr<InputSource> compressed,
+                                               std::string prefix);
+
+#endif // JWT_MAIN_DECOMPRESS_H
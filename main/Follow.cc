@@ -0,0 +1,422 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Follow.h"
+
+#include <stdexcept>
+
+#include "libjwt/config.h"
+
+#if defined(JWT_OS_LINUX)
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "libjwt/Decoder.h"
+#include "libjwt/InputError.h"
+#include "libjwt/Jwt.h"
+#include "libjwt/JwtError.h"
+#include "libjwt/Stats.h"
+#include "libjwt/TokenScanner.h"
+
+#include "Posix.h"
+#include "StringBuf.h"
+
+namespace {
+
+constexpr std::size_t kReadSize = 1 << 20;
+
+// How often to look at the file when inotify stays quiet, as it does for
+// writes to a file that was renamed out of the watched name, or on network
+// file systems.
+constexpr int kPollIntervalMs = 1000;
+
+// Where following a file got to.  The device and inode tell whether the
+// file at the path is still the same one.
+struct Checkpoint
+{
+  std::uint64_t device {0};
+  std::uint64_t inode {0};
+  std::uint64_t offset {0};
+};
+
+bool load_checkpoint(const std::string& path, Checkpoint& checkpoint)
+{
+  std::ifstream in{path};
+  return static_cast<bool>(in >> checkpoint.device >> checkpoint.inode >> checkpoint.offset);
+}
+
+// Writes a new file and renames it over the old one, so that a crash leaves
+// one checkpoint or the other but never half of one.
+void save_checkpoint(const std::string& path, const Checkpoint& checkpoint)
+{
+  auto temp_path = path + ".tmp";
+  {
+    std::ofstream out{temp_path, std::ios::trunc};
+    out << checkpoint.device << ' ' << checkpoint.inode << ' ' << checkpoint.offset << '\n';
+    out.flush();
+    if (!out)
+    {
+      throw std::runtime_error("Could not write state to " + temp_path);
+    }
+  }
+
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+  {
+    throw_errno("rename " + path);
+  }
+}
+
+class Follower
+{
+public:
+  Follower(const std::string& path, const std::string& state_path, bool separate_tokens, const TokenPrinter& print);
+
+  void run();
+
+private:
+  // Opens the file now at path_, from its start.  Returns false if there is
+  // none.
+  bool open_file(struct stat& st);
+
+  // Opens the file at the checkpointed offset, if the state file refers to it.
+  void resume();
+
+  // Reads everything appended so far, handling each complete line.
+  void drain();
+
+  // Scans the complete lines in pending_, or all of it at the end of a file
+  // that will not grow any more.
+  void process(bool end_of_file);
+
+  void write_output();
+
+  // Switches to a new file at path_, or back to the start of a truncated
+  // one.  Returns true if it did either.
+  bool check_file();
+
+  void wait_for_change();
+
+  std::string path_;
+  std::string state_path_;
+  bool separate_tokens_;
+  const TokenPrinter& print_;
+
+  FileDescriptor inotify_ {-1};
+  FileDescriptor file_ {-1};
+
+  // The open file, and the offset in it of pending_'s first byte.
+  Checkpoint checkpoint_;
+  std::string pending_;
+  std::vector<char> buffer_;
+
+  jwt::Decoder decoder_;
+  jwt::Jwt token_;
+  jwt::JwtError error_;
+
+  std::string output_;
+  StringBuf output_buffer_ {output_};
+  std::ostream output_stream_ {&output_buffer_};
+  bool first_;
+};
+
+Follower::Follower(const std::string& path, const std::string& state_path, bool separate_tokens, const TokenPrinter& print)
+  : path_(path)
+  , state_path_(state_path)
+  , separate_tokens_(separate_tokens)
+  , print_(print)
+  , buffer_(kReadSize)
+  , first_(separate_tokens)
+{
+  if (!std::filesystem::exists(path))
+  {
+    throw jwt::InputError{"No such file: " + path};
+  }
+
+  inotify_.reset(inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+  if (inotify_.get() == -1)
+  {
+    throw_errno("inotify_init1");
+  }
+
+  // Watching the directory rather than the file also catches a new file
+  // being created or moved in under the same name.
+  auto directory = std::filesystem::path{path}.parent_path();
+  if (directory.empty())
+  {
+    directory = ".";
+  }
+
+  auto mask = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+  if (inotify_add_watch(inotify_.get(), directory.c_str(), mask) == -1)
+  {
+    throw_errno("inotify_add_watch " + directory.string());
+  }
+}
+
+bool Follower::open_file(struct stat& st)
+{
+  int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+  {
+    if (errno == ENOENT)
+    {
+      return false;
+    }
+    throw_errno("open " + path_);
+  }
+
+  file_.reset(fd);
+  if (fstat(fd, &st) != 0)
+  {
+    throw_errno("fstat " + path_);
+  }
+
+  checkpoint_.device = static_cast<std::uint64_t>(st.st_dev);
+  checkpoint_.inode = static_cast<std::uint64_t>(st.st_ino);
+  checkpoint_.offset = 0;
+  pending_.clear();
+  return true;
+}
+
+void Follower::resume()
+{
+  struct stat st;
+  if (!open_file(st))
+  {
+    throw jwt::InputError{"No such file: " + path_};
+  }
+
+  Checkpoint saved;
+  if (state_path_.empty() || !load_checkpoint(state_path_, saved))
+  {
+    return;
+  }
+
+  // A checkpoint for another file means the log was rotated while we were
+  // not running; one past the end means it was truncated.  Either way, the
+  // current file is all new.
+  if (saved.device != checkpoint_.device || saved.inode != checkpoint_.inode
+      || saved.offset > static_cast<std::uint64_t>(st.st_size))
+  {
+    return;
+  }
+
+  if (lseek(file_.get(), static_cast<off_t>(saved.offset), SEEK_SET) == -1)
+  {
+    throw_errno("lseek " + path_);
+  }
+  checkpoint_.offset = saved.offset;
+}
+
+void Follower::drain()
+{
+  while (!g_stop)
+  {
+    ssize_t n;
+    {
+      jwt::ScopedPhase phase{jwt::Phase::Read};
+      n = read(file_.get(), buffer_.data(), buffer_.size());
+      phase.add_bytes(n > 0 ? static_cast<std::size_t>(n) : 0);
+    }
+
+    if (n == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      throw_errno("read " + path_);
+    }
+    if (n == 0)
+    {
+      return;
+    }
+
+    pending_.append(buffer_.data(), static_cast<std::size_t>(n));
+    process(false);
+  }
+}
+
+void Follower::process(bool end_of_file)
+{
+  std::size_t end = pending_.size();
+  if (!end_of_file)
+  {
+    auto newline = pending_.rfind('\n');
+    end = newline != std::string::npos ? newline + 1 : 0;
+  }
+  if (end == 0)
+  {
+    return;
+  }
+
+  // Every chunk starts at the beginning of a line, so the scanner's default
+  // of a preceding newline holds, and no token can run past its end.
+  jwt::find_tokens(std::string_view{pending_.data(), end}, [&](std::string_view text, std::uint64_t offset) {
+    if (!decoder_.try_parse_into(text, token_, error_))
+    {
+      write_output();
+      std::cerr << "Skipping token at offset " << checkpoint_.offset + offset << ": " << error_.message() << '\n';
+      return;
+    }
+
+    // As in the pipeline, every token is preceded by a separator, except the
+    // very first and any that print nothing.
+    auto mark = output_.size();
+    if (separate_tokens_)
+    {
+      output_stream_ << '\n';
+    }
+
+    auto printed = output_.size();
+    print_(output_stream_, decoder_, token_);
+    if (output_.size() == printed)
+    {
+      output_.resize(mark);
+    }
+  });
+
+  write_output();
+
+  pending_.erase(0, end);
+  checkpoint_.offset += end;
+  if (!state_path_.empty())
+  {
+    save_checkpoint(state_path_, checkpoint_);
+  }
+}
+
+void Follower::write_output()
+{
+  std::string_view output{output_};
+  if (first_ && !output.empty())
+  {
+    output.remove_prefix(1);
+    first_ = false;
+  }
+
+  std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+  std::cout.flush();
+  output_.clear();
+}
+
+bool Follower::check_file()
+{
+  struct stat st;
+  if (stat(path_.c_str(), &st) != 0)
+  {
+    if (errno == ENOENT)
+    {
+      // Renamed or deleted, and not yet replaced; keep reading the old file
+      // in the meantime.
+      return false;
+    }
+    throw_errno("stat " + path_);
+  }
+
+  if (static_cast<std::uint64_t>(st.st_dev) != checkpoint_.device
+      || static_cast<std::uint64_t>(st.st_ino) != checkpoint_.inode)
+  {
+    // Rotated.  Anything written to the old file before its writer moved on
+    // still counts, including a last line without a newline.
+    drain();
+    process(true);
+    return open_file(st);
+  }
+
+  if (static_cast<std::uint64_t>(st.st_size) < checkpoint_.offset + pending_.size())
+  {
+    // Truncated in place, e.g. by logrotate's copytruncate.
+    if (lseek(file_.get(), 0, SEEK_SET) == -1)
+    {
+      throw_errno("lseek " + path_);
+    }
+    checkpoint_.offset = 0;
+    pending_.clear();
+    return true;
+  }
+
+  return false;
+}
+
+void Follower::wait_for_change()
+{
+  pollfd fd {inotify_.get(), POLLIN, 0};
+  int count = poll(&fd, 1, kPollIntervalMs);
+  if (count == -1)
+  {
+    if (errno == EINTR)
+    {
+      return;
+    }
+    throw_errno("poll");
+  }
+
+  // Events only wake us up; check_file() works out what happened.
+  alignas(inotify_event) char events[4096];
+  while (read(inotify_.get(), events, sizeof(events)) > 0)
+  {
+  }
+}
+
+void Follower::run()
+{
+  resume();
+
+  while (!g_stop)
+  {
+    drain();
+    if (check_file())
+    {
+      continue;
+    }
+    wait_for_change();
+  }
+}
+
+} // anonymous namespace
+
+void follow(const std::string& path, const std::string& state_path, const PipelineOptions& options, const TokenPrinter& print)
+{
+  handle_stop_signals();
+
+  Follower follower{path, state_path, options.separate_tokens, print};
+  follower.run();
+}
+
+#else
+
+void follow(const std::string&, const std::string&, const PipelineOptions&, const TokenPrinter&)
+{
+  throw std::runtime_error("--follow is only supported on Linux");
+}
+
+#endif
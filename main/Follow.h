@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_FOLLOW_H
+#define JWT_MAIN_FOLLOW_H
+
+#pragma once
+
+#include <string>
+
+#include "Pipeline.h"
+
+// Decodes and prints every token in `path`, then keeps watching it like
+// `tail -F`, decoding lines as they are appended, until SIGINT or SIGTERM.
+//
+// Only complete lines are scanned; a partial line waits for its newline.
+// When the file is renamed away and recreated, whatever was left in the old
+// one is finished before moving on to the new one from its start.  When it
+// is truncated in place, it is read again from the start.
+//
+// If `state_path` is not empty, the file's identity and the offset just past
+// the last line processed are saved there after each batch of output, and a
+// later run over the same file resumes from that offset.  Output is written
+// before the state, so a crash may repeat tokens but never skips any.
+//
+// The directory holding `path` is watched with inotify, with a periodic
+// check as a backstop.  Linux only; elsewhere this throws.
+// Of `options`, only separate_tokens applies.
+void follow(const std::string& path, const std::string& state_path, const PipelineOptions& options, const TokenPrinter& print);
+
+#endif // JWT_MAIN_FOLLOW_H
@@ -0,0 +1,200 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Index.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "libjwt/Decoder.h"
+#include "libjwt/InputError.h"
+#include "libjwt/Jwt.h"
+#include "libjwt/JwtError.h"
+
+#include "Decompress.h"
+#include "InputSource.h"
+#include "PerThread.h"
+
+namespace {
+
+constexpr std::size_t kReadSize = 1 << 20;
+
+// Guards against pointing into a file that has changed since, which would
+// otherwise show up as a confusing decoding error.
+std::string_view if_token(std::string_view text)
+{
+  return text.substr(0, 3) == "eyJ" ? text : std::string_view{};
+}
+
+}
+
+void build_index(const std::string& index_path, const std::vector<std::string>& files, const PipelineOptions& options)
+{
+  // Tokens are decoded right where they are found, on the scanning threads,
+  // each into its own builder, which spills sorted runs of entries next to
+  // the index.
+  struct Partial
+  {
+    explicit Partial(std::string run_path) : builder(std::move(run_path)) {}
+
+    jwt::Decoder decoder;
+    jwt::Jwt token;
+    jwt::JwtError error;
+    jwt::ClaimIndexBuilder builder;
+    std::uint64_t skipped {0};
+  };
+
+  std::atomic<int> next_run {0};
+  PerThread<Partial> partials{[&index_path, &next_run] {
+    return std::make_unique<Partial>(index_path + ".run" + std::to_string(next_run++));
+  }};
+  scan_files(files, options, [&partials](std::size_t source, std::string_view text, std::uint64_t offset, std::uint64_t line) {
+    auto& partial = partials.local();
+    if (partial.decoder.try_parse_into(text, partial.token, partial.error))
+    {
+      partial.builder.add(partial.token, static_cast<std::uint32_t>(source), offset, line, static_cast<std::uint32_t>(text.size()));
+    }
+    else
+    {
+      ++partial.skipped;
+    }
+  });
+
+  std::vector<jwt::ClaimIndexBuilder*> builders;
+  std::uint64_t skipped = 0;
+  partials.for_each([&builders, &skipped](Partial& partial) {
+    builders.push_back(&partial.builder);
+    skipped += partial.skipped;
+  });
+
+  std::vector<std::string> paths;
+  for (const auto& file : files)
+  {
+    paths.push_back(std::filesystem::absolute(file).string());
+  }
+
+  auto temp_path = index_path + ".tmp";
+  {
+    std::ofstream out{temp_path, std::ios::binary | std::ios::trunc};
+    jwt::ClaimIndexBuilder::write(out, builders, paths);
+    out.flush();
+    if (!out)
+    {
+      throw std::runtime_error("Could not write index to " + temp_path);
+    }
+  }
+  if (std::rename(temp_path.c_str(), index_path.c_str()) != 0)
+  {
+    throw std::runtime_error("Could not rename " + temp_path + " to " + index_path);
+  }
+
+  if (skipped > 0)
+  {
+    std::cerr << "Left out " << skipped << " tokens that could not be decoded" << std::endl;
+  }
+}
+
+IndexedTokens::IndexedTokens(const jwt::ClaimIndex& index, const std::vector<jwt::IndexEntry>& entries, bool allow_io_uring)
+  : texts_(entries.size())
+{
+  // Visit each file once, front to back.
+  std::vector<std::size_t> order(entries.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::sort(order.begin(), order.end(), [&entries](std::size_t a, std::size_t b) {
+    return std::tie(entries[a].source, entries[a].offset) < std::tie(entries[b].source, entries[b].offset);
+  });
+
+  for (std::size_t group = 0; group < order.size();)
+  {
+    auto source = entries[order[group]].source;
+    auto end = group;
+    while (end < order.size() && entries[order[end]].source == source)
+    {
+      ++end;
+    }
+
+    std::string path{index.source(source)};
+    try
+    {
+      if (detect_file_compression(path) == Compression::None)
+      {
+        files_.push_back(std::make_unique<MappedFile>(path));
+        auto data = files_.back()->data();
+        for (auto i = group; i < end; ++i)
+        {
+          const auto& entry = entries[order[i]];
+          if (entry.offset + entry.length <= data.size())
+          {
+            texts_[order[i]] = if_token(data.substr(static_cast<std::size_t>(entry.offset), entry.length));
+          }
+        }
+      }
+      else
+      {
+        // Offsets count decompressed bytes, so the stream has to be read up
+        // to each token, keeping only from the current one on.
+        auto input = open_input(path, allow_io_uring);
+        std::string buffer;
+        std::uint64_t start = 0;
+        bool more = true;
+        for (auto i = group; i < end; ++i)
+        {
+          const auto& entry = entries[order[i]];
+          auto drop = static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size(), entry.offset - start));
+          buffer.erase(0, drop);
+          start += drop;
+
+          while (more && start + buffer.size() < entry.offset + entry.length)
+          {
+            auto size = buffer.size();
+            buffer.resize(size + kReadSize);
+            auto read = input->read(&buffer[size], kReadSize);
+            buffer.resize(size + read);
+            more = read > 0;
+
+            if (start + buffer.size() <= entry.offset)
+            {
+              start += buffer.size();
+              buffer.clear();
+            }
+          }
+
+          if (start <= entry.offset && entry.offset + entry.length <= start + buffer.size())
+          {
+            copies_.emplace_back(buffer, static_cast<std::size_t>(entry.offset - start), entry.length);
+            texts_[order[i]] = if_token(copies_.back());
+          }
+        }
+      }
+    }
+    catch (const jwt::InputError& ex)
+    {
+      std::cerr << ex.what() << std::endl;
+    }
+
+    group = end;
+  }
+}
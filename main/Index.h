@@ -0,0 +1,66 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_INDEX_H
+#define JWT_MAIN_INDEX_H
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libjwt/ClaimIndex.h"
+
+#include "MappedFile.h"
+#include "Pipeline.h"
+
+// Decodes every token in `files`, scanning them as scan_files does, and
+// writes a claim index of them to `index_path`, naming each file by its
+// absolute path.  Tokens that fail to decode are left out, and counted on
+// stderr.
+//
+// The index is built in memory and sorted before it is written, through a
+// temporary file that replaces `index_path` only once complete.
+void build_index(const std::string& index_path, const std::vector<std::string>& files, const PipelineOptions& options);
+
+// The text of tokens that an index points to, read back from the logs it was
+// built from.  Plain files are mapped, so only the pages holding the tokens
+// are read; compressed ones are decompressed as far as the last token needed.
+class IndexedTokens
+{
+public:
+  // Unreadable files are reported on stderr, and their tokens left empty.
+  IndexedTokens(const jwt::ClaimIndex& index, const std::vector<jwt::IndexEntry>& entries, bool allow_io_uring);
+
+  // The text of entries[i], or empty if its file no longer holds a token
+  // there, e.g. because it was rewritten since it was indexed.
+  std::string_view text(std::size_t i) const { return texts_[i]; }
+
+private:
+  std::vector<std::unique_ptr<MappedFile>> files_;
+
+  // Copies of tokens from compressed files; a deque, so that they stay put.
+  std::deque<std::string> copies_;
+
+  std::vector<std::string_view> texts_;
+};
+
+#endif // JWT_MAIN_INDEX_H
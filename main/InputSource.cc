@@ -0,0 +1,151 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "InputSource.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "libjwt/config.h"
+#include "libjwt/InputError.h"
+
+#include "Decompress.h"
+#include "UringSource.h"
+
+FileSource::FileSource(const std::string& path, ByteRange range)
+    : file_(stdin)
+    , remaining_(range.end - range.begin)
+{
+  if (path.empty())
+  {
+    return;
+  }
+
+  file_ = std::fopen(path.c_str(), "rb");
+  if (file_ == nullptr)
+  {
+    throw jwt::InputError{"Could not open " + path};
+  }
+
+  if (range.begin > 0)
+  {
+#if defined(JWT_OS_WIN)
+    int rc = _fseeki64(file_, static_cast<__int64>(range.begin), SEEK_SET);
+#else
+    int rc = fseeko(file_, static_cast<off_t>(range.begin), SEEK_SET);
+#endif
+    if (rc != 0)
+    {
+      std::fclose(file_);
+      throw jwt::InputError{"Could not seek in " + path};
+    }
+  }
+}
+
+FileSource::~FileSource()
+{
+  if (file_ != stdin)
+  {
+    std::fclose(file_);
+  }
+}
+
+std::size_t FileSource::read(char* buffer, std::size_t size)
+{
+  size = static_cast<std::size_t>(std::min<std::uint64_t>(size, remaining_));
+  if (size == 0)
+  {
+    return 0;
+  }
+
+  auto num_read = std::fread(buffer, 1, size, file_);
+  remaining_ -= num_read;
+  if (num_read == 0 && std::ferror(file_))
+  {
+    throw jwt::InputError{"Error reading input"};
+  }
+  return num_read;
+}
+
+namespace {
+
+// Hands back bytes that were read ahead, e.g. to sniff a format, before
+// reading on from the source.
+class PrefixedSource : public InputSource
+{
+public:
+  PrefixedSource(std::string prefix, std::unique_ptr<InputSource> source)
+      : prefix_(std::move(prefix))
+      , source_(std::move(source))
+  {}
+
+  std::size_t read(char* buffer, std::size_t size) override
+  {
+    auto n = std::min(size, prefix_.size() - prefix_pos_);
+    std::memcpy(buffer, prefix_.data() + prefix_pos_, n);
+    prefix_pos_ += n;
+
+    return n < size ? n + source_->read(buffer + n, size - n) : n;
+  }
+
+private:
+  std::string prefix_;
+  std::size_t prefix_pos_ {0};
+  std::unique_ptr<InputSource> source_;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<InputSource> open_input(const std::string& path, bool allow_io_uring, ByteRange range)
+{
+  std::unique_ptr<InputSource> source;
+  if (allow_io_uring && !path.empty())
+  {
+    source = UringSource::open(path, range);
+  }
+  if (!source)
+  {
+    source = std::make_unique<FileSource>(path, range);
+  }
+
+  if (range.begin > 0)
+  {
+    // The middle of a compressed file cannot be decompressed on its own.
+    return source;
+  }
+
+  std::string magic(4, '\0');
+  std::size_t size = 0;
+  while (size < magic.size())
+  {
+    auto n = source->read(magic.data() + size, magic.size() - size);
+    if (n == 0)
+    {
+      break;
+    }
+    size += n;
+  }
+  magic.resize(size);
+
+  auto compression = detect_compression(magic);
+  if (compression != Compression::None)
+  {
+    return open_decompressor(compression, std::move(source), std::move(magic));
+  }
+  return std::make_unique<PrefixedSource>(std::move(magic), std::move(source));
+}
@@ -0,0 +1,71 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_INPUTSOURCE_H
+#define JWT_MAIN_INPUTSOURCE_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+
+// The part of a file to read: [begin, end), clamped to the file's size.
+struct ByteRange
+{
+  std::uint64_t begin {0};
+  std::uint64_t end {std::numeric_limits<std::uint64_t>::max()};
+};
+
+// A stream of raw bytes to scan for tokens.
+class InputSource
+{
+public:
+  virtual ~InputSource() = default;
+
+  // Reads up to `size` bytes into `buffer`, returning 0 only at the end of
+  // input.  Throws InputError on failure.
+  virtual std::size_t read(char* buffer, std::size_t size) = 0;
+};
+
+// Reads a file through stdio, or stdin if the path is empty.
+class FileSource : public InputSource
+{
+public:
+  explicit FileSource(const std::string& path, ByteRange range = {});
+  ~FileSource() override;
+
+  FileSource(const FileSource&) = delete;
+  FileSource& operator=(const FileSource&) = delete;
+
+  std::size_t read(char* buffer, std::size_t size) override;
+
+private:
+  FILE* file_;
+  std::uint64_t remaining_;
+};
+
+// Opens the best available source for `path`: io_uring for regular files
+// where the kernel allows it, otherwise stdio.  An empty path means stdin,
+// which cannot have a range.  gzip and zstd streams, recognized by their
+// magic numbers, are decompressed on the fly.
+std::unique_ptr<InputSource> open_input(const std::string& path, bool allow_io_uring = true, ByteRange range = {});
+
+#endif // JWT_MAIN_INPUTSOURCE_H
@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Inputs.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#include "libjwt/config.h"
+#include "libjwt/InputError.h"
+
+#if defined(JWT_OS_NIX)
+#  include <glob.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+#if defined(JWT_OS_NIX)
+bool has_wildcards(const std::string& path)
+{
+  return path.find_first_of("*?[") != std::string::npos;
+}
+#endif
+
+void add_path(const std::string& path, std::vector<std::string>& files)
+{
+  std::error_code ec;
+  auto status = fs::status(path, ec);
+  if (ec || !fs::exists(status))
+  {
+    throw jwt::InputError{"No such file or directory: " + path};
+  }
+
+  if (!fs::is_directory(status))
+  {
+    files.push_back(path);
+    return;
+  }
+
+  std::vector<std::string> found;
+  auto options = fs::directory_options::skip_permission_denied;
+  for (fs::recursive_directory_iterator it{path, options, ec}, end; !ec && it != end; it.increment(ec))
+  {
+    if (it->is_regular_file(ec))
+    {
+      found.push_back(it->path().string());
+    }
+  }
+  if (ec)
+  {
+    throw jwt::InputError{"Could not read directory " + path + ": " + ec.message()};
+  }
+
+  std::sort(found.begin(), found.end());
+  files.insert(files.end(), found.begin(), found.end());
+}
+
+} // anonymous namespace
+
+std::vector<std::string> expand_inputs(const std::vector<std::string>& args)
+{
+  std::vector<std::string> files;
+  for (const auto& arg : args)
+  {
+#if defined(JWT_OS_NIX)
+    std::error_code ec;
+    if (has_wildcards(arg) && !fs::exists(arg, ec))
+    {
+      glob_t matches;
+      int rc = glob(arg.c_str(), 0, nullptr, &matches);
+      if (rc != 0)
+      {
+        globfree(&matches);
+        throw jwt::InputError{"No files match " + arg};
+      }
+
+      // glob() sorts its results.
+      for (std::size_t i = 0; i < matches.gl_pathc; ++i)
+      {
+        add_path(matches.gl_pathv[i], files);
+      }
+      globfree(&matches);
+      continue;
+    }
+#endif
+
+    add_path(arg, files);
+  }
+  return files;
+}
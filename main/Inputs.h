@@ -0,0 +1,33 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_INPUTS_H
+#define JWT_MAIN_INPUTS_H
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Turns command-line paths into the list of files to scan.  Directories are
+// walked recursively, and patterns with wildcards that the shell left alone
+// (e.g. because they were quoted) are expanded; both in sorted order, so
+// that output is reproducible.  Throws InputError for a path that does not
+// exist or a pattern that matches nothing.
+std::vector<std::string> expand_inputs(const std::vector<std::string>& args);
+
+#endif // JWT_MAIN_INPUTS_H
@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MappedFile.h"
+
+#include "libjwt/config.h"
+#include "libjwt/InputError.h"
+
+#if defined(JWT_OS_NIX)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#else
+#  include <fstream>
+#  include <iterator>
+#endif
+
+MappedFile::MappedFile(const std::string& path)
+{
+#if defined(JWT_OS_NIX)
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    throw jwt::InputError{"Could not open " + path};
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+  {
+    close(fd);
+    throw jwt::InputError{"Could not map " + path};
+  }
+
+  auto size = static_cast<std::size_t>(st.st_size);
+  if (size > 0)
+  {
+    mapping_ = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+
+  if (mapping_ == MAP_FAILED)
+  {
+    mapping_ = nullptr;
+    throw jwt::InputError{"Could not map " + path};
+  }
+  data_ = std::string_view{static_cast<const char*>(mapping_), mapping_ != nullptr ? size : 0};
+#else
+  std::ifstream file{path, std::ios::binary};
+  if (!file)
+  {
+    throw jwt::InputError{"Could not open " + path};
+  }
+  contents_.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+  if (file.bad())
+  {
+    throw jwt::InputError{"Error reading " + path};
+  }
+  data_ = contents_;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(JWT_OS_NIX)
+  if (mapping_ != nullptr)
+  {
+    munmap(mapping_, data_.size());
+  }
+#endif
+}
@@ -0,0 +1,47 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_MAPPEDFILE_H
+#define JWT_MAIN_MAPPEDFILE_H
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// A whole file, mapped read-only into memory where the platform allows it
+// and read into memory otherwise.
+class MappedFile
+{
+public:
+  // Throws InputError if the file cannot be opened or read.
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  std::string_view data() const { return data_; }
+
+private:
+  std::string_view data_;
+  void* mapping_ {nullptr};
+  std::string contents_;
+};
+
+#endif // JWT_MAIN_MAPPEDFILE_H
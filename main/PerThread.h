@@ -0,0 +1,101 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_PERTHREAD_H
+#define JWT_MAIN_PERTHREAD_H
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Gives each thread its own T, to build up without locking and combine once
+// the threads are done, e.g. partial aggregates that merge.
+//
+// Like Trace's buffers, instances belong to the PerThread rather than the
+// thread, and each thread remembers the last one it used.  A thread that
+// alternates between two PerThreads of the same T gets a fresh instance on
+// each switch, which is only wasteful.
+template <typename T>
+class PerThread
+{
+public:
+  using Factory = std::function<std::unique_ptr<T>()>;
+
+  // Instances come from `make`, or are default-constructed.
+  explicit PerThread(Factory make = [] { return std::make_unique<T>(); })
+    : id_(next_id())
+    , make_(std::move(make))
+  {}
+
+  PerThread(const PerThread&) = delete;
+  PerThread& operator=(const PerThread&) = delete;
+
+  // The calling thread's instance, made on first use.
+  T& local()
+  {
+    thread_local Slot slot;
+    if (slot.owner == id_)
+    {
+      return *slot.value;
+    }
+
+    auto value = make_();
+    std::lock_guard<std::mutex> lock{mutex_};
+    instances_.push_back(std::move(value));
+    slot = Slot{id_, instances_.back().get()};
+    return *slot.value;
+  }
+
+  // Calls `f` with every instance.  Only call this once the threads using
+  // them are done.
+  template <typename F>
+  void for_each(F&& f) const
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (const auto& instance : instances_)
+    {
+      f(*instance);
+    }
+  }
+
+private:
+  struct Slot
+  {
+    std::uint64_t owner {0};
+    T* value {nullptr};
+  };
+
+  static std::uint64_t next_id()
+  {
+    static std::atomic<std::uint64_t> next {1};
+    return next++;
+  }
+
+  const std::uint64_t id_;
+  const Factory make_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<T>> instances_;
+};
+
+#endif // JWT_MAIN_PERTHREAD_H
@@ -0,0 +1,614 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Pipeline.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "libjwt/JwtError.h"
+#include "libjwt/Stats.h"
+#include "libjwt/TokenScanner.h"
+#include "libjwt/Trace.h"
+
+#include "Decompress.h"
+#include "SpscQueue.h"
+#include "StringBuf.h"
+#include "ThreadPool.h"
+
+namespace {
+
+constexpr std::size_t kReadSize = 1 << 20;
+
+// Big enough to amortize queue traffic, small enough to keep output flowing.
+constexpr std::size_t kBatchSize = 256;
+
+// Batches in flight per decoder, in each direction.
+constexpr std::size_t kQueueDepth = 8;
+
+// How much output a file task collects before handing it to the writer, and
+// how many such chunks a file may have waiting.
+constexpr std::size_t kFileChunkSize = 64 * 1024;
+constexpr std::size_t kFileQueueDepth = 16;
+
+// The smallest part of a file worth scanning on its own thread.
+constexpr std::uint64_t kMinRangeSize = 8 << 20;
+
+struct Batch
+{
+  struct Token
+  {
+    std::size_t begin;
+    std::size_t size;
+    std::uint64_t offset;
+  };
+
+  // Set only by run_tokens(), one per token.
+  struct Note
+  {
+    std::string where;
+    std::string text;
+  };
+
+  // The tokens' text, back to back, so that the read buffer can be reused.
+  std::string text;
+  std::vector<Token> tokens;
+  std::vector<Note> notes;
+
+  std::string output;
+  std::string errors;
+};
+
+using BatchQueue = SpscQueue<std::unique_ptr<Batch>>;
+
+// Hands a full batch to the decoders.
+using BatchSink = std::function<void(std::unique_ptr<Batch>)>;
+
+template <typename T>
+void push_waiting(SpscQueue<T>& queue, T value)
+{
+  if (queue.try_push(value))
+  {
+    return;
+  }
+
+  jwt::ScopedSpan span{"queue_full"};
+  queue.push(std::move(value));
+}
+
+template <typename T>
+T pop_waiting(SpscQueue<T>& queue)
+{
+  T value;
+  if (queue.try_pop(value))
+  {
+    return value;
+  }
+
+  jwt::ScopedSpan span{"queue_empty"};
+  return queue.pop();
+}
+
+void decode_batches(std::size_t index, BatchQueue& in, BatchQueue& out, const PipelineOptions& options, const TokenPrinter& print)
+{
+  if (auto* trace = jwt::current_trace())
+  {
+    trace->set_thread_name("decoder " + std::to_string(index + 1));
+  }
+
+  jwt::Decoder decoder;
+  jwt::Jwt token;
+  jwt::JwtError error;
+
+  std::string scratch;
+  StringBuf buffer{scratch};
+  std::ostream os{&buffer};
+
+  while (auto batch = pop_waiting(in))
+  {
+    buffer.reset(batch->output);
+    for (std::size_t i = 0; i < batch->tokens.size(); ++i)
+    {
+      const auto& t = batch->tokens[i];
+      const auto* note = batch->notes.empty() ? nullptr : &batch->notes[i];
+
+      std::string_view text{batch->text.data() + t.begin, t.size};
+      if (!decoder.try_parse_into(text, token, error))
+      {
+        auto where = note != nullptr ? note->where : "offset " + std::to_string(t.offset);
+        batch->errors += "Skipping token at " + where + ": " + error.message() + '\n';
+        continue;
+      }
+
+      // Separates this token from the previous one; the writer drops the
+      // very first separator.  A token that prints nothing, e.g. because it
+      // is only being tallied, gets no separator or note either.
+      auto mark = batch->output.size();
+      if (options.separate_tokens)
+      {
+        os << '\n';
+      }
+      if (note != nullptr)
+      {
+        os << note->text << '\n';
+      }
+
+      auto printed = batch->output.size();
+      print(os, decoder, token);
+      if (batch->output.size() == printed)
+      {
+        batch->output.resize(mark);
+      }
+    }
+
+    push_waiting(out, std::move(batch));
+  }
+
+  out.push(nullptr);
+}
+
+// Writes one batch's output and errors.  While `first` is set, the output's
+// leading separator is dropped, so that the run does not start with one.
+void write_batch(const Batch& batch, bool& first)
+{
+  jwt::ScopedPhase phase{jwt::Phase::Write, batch.output.size()};
+
+  if (!batch.errors.empty())
+  {
+    std::cout.flush();
+    std::cerr << batch.errors;
+  }
+
+  std::string_view output{batch.output};
+  if (first && !output.empty())
+  {
+    output.remove_prefix(1);
+    first = false;
+  }
+  std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+}
+
+void write_batches(std::vector<std::unique_ptr<BatchQueue>>& queues, bool separated)
+{
+  if (auto* trace = jwt::current_trace())
+  {
+    trace->set_thread_name("writer");
+  }
+
+  bool first = separated;
+  for (std::size_t next = 0; ; next = (next + 1) % queues.size())
+  {
+    auto batch = pop_waiting(*queues[next]);
+    if (!batch)
+    {
+      // The reader ends every queue in turn, so this is the last batch.
+      break;
+    }
+
+    write_batch(*batch, first);
+  }
+}
+
+// One file, or part of one, scanned by a single pool task.
+struct FileJob
+{
+  std::string path;
+  ByteRange range;
+
+  // Whether tokens are labelled with path and line; without labels, errors
+  // give the byte offset within the whole file instead.
+  bool labelled {true};
+
+  BatchQueue output {kFileQueueDepth};
+};
+
+// Scans, decodes and prints one job on a pool thread, streaming its output
+// in chunks and ending with a null chunk.
+void process_job(FileJob& job, const PipelineOptions& options, const TokenPrinter& print)
+{
+  jwt::ScopedSpan span{"file"};
+
+  jwt::Decoder decoder;
+  jwt::Jwt token;
+  jwt::JwtError error;
+
+  auto chunk = std::make_unique<Batch>();
+  StringBuf buffer{chunk->output};
+  std::ostream os{&buffer};
+
+  try
+  {
+    auto source = open_input(job.path, options.use_io_uring, job.range);
+    scan_source(*source, [&](std::string_view text, std::uint64_t offset, std::uint64_t line) {
+      if (!decoder.try_parse_into(text, token, error))
+      {
+        auto where = job.labelled
+            ? job.path + ':' + std::to_string(line)
+            : "offset " + std::to_string(job.range.begin + offset);
+        chunk->errors += "Skipping token at " + where + ": " + error.message() + '\n';
+        return;
+      }
+
+      auto mark = chunk->output.size();
+      if (options.separate_tokens)
+      {
+        os << '\n';
+        if (job.labelled)
+        {
+          os << job.path << ':' << line << '\n';
+        }
+      }
+
+      auto printed = chunk->output.size();
+      print(os, decoder, token);
+      if (chunk->output.size() == printed)
+      {
+        chunk->output.resize(mark);
+      }
+
+      if (chunk->output.size() >= kFileChunkSize)
+      {
+        push_waiting(job.output, std::move(chunk));
+        chunk = std::make_unique<Batch>();
+        buffer.reset(chunk->output);
+      }
+    });
+  }
+  catch (const std::exception& ex)
+  {
+    // One unreadable file should not stop the others.
+    chunk->errors += job.path + ": " + ex.what() + '\n';
+  }
+
+  push_waiting(job.output, std::move(chunk));
+  job.output.push(nullptr);
+}
+
+// Runs every job on a pool and writes their output in order.
+void run_jobs(std::vector<std::unique_ptr<FileJob>>& jobs, std::size_t num_threads,
+              const PipelineOptions& options, const TokenPrinter& print)
+{
+  ThreadPool pool{std::min(num_threads, std::max<std::size_t>(jobs.size(), 1)), "worker"};
+
+  // Tasks start in submission order, so the job being written is always
+  // running or done, and jobs waiting on a full queue cannot starve it.
+  for (auto& job : jobs)
+  {
+    pool.submit([&job = *job, &options, &print] { process_job(job, options, print); });
+  }
+
+  bool first = options.separate_tokens;
+  for (auto& job : jobs)
+  {
+    while (auto chunk = pop_waiting(job->output))
+    {
+      write_batch(*chunk, first);
+    }
+  }
+}
+
+// Runs the decoder and writer stages of run_pipeline() on batches from
+// `produce`, which runs on the calling thread.
+void run_stages(const std::function<void(const BatchSink&)>& produce, const PipelineOptions& options, const TokenPrinter& print)
+{
+  const auto num_decoders = options.decoder_threads > 0 ? options.decoder_threads : 1;
+
+  std::vector<std::unique_ptr<BatchQueue>> to_decoders;
+  std::vector<std::unique_ptr<BatchQueue>> to_writer;
+  for (std::size_t i = 0; i < num_decoders; ++i)
+  {
+    to_decoders.push_back(std::make_unique<BatchQueue>(kQueueDepth));
+    to_writer.push_back(std::make_unique<BatchQueue>(kQueueDepth));
+  }
+
+  std::vector<std::thread> decoders;
+  for (std::size_t i = 0; i < num_decoders; ++i)
+  {
+    decoders.emplace_back(decode_batches, i, std::ref(*to_decoders[i]), std::ref(*to_writer[i]), std::cref(options), std::cref(print));
+  }
+  std::thread writer{write_batches, std::ref(to_writer), options.separate_tokens};
+
+  std::size_t next_decoder = 0;
+  BatchSink dispatch = [&](std::unique_ptr<Batch> batch) {
+    push_waiting(*to_decoders[next_decoder], std::move(batch));
+    next_decoder = (next_decoder + 1) % num_decoders;
+  };
+
+  // Whatever happens to the producer, the other stages must be told to stop
+  // before their threads can be joined.
+  auto finish = [&] {
+    for (std::size_t i = 0; i < num_decoders; ++i)
+    {
+      dispatch(nullptr);
+    }
+    for (auto& decoder : decoders)
+    {
+      decoder.join();
+    }
+    writer.join();
+  };
+
+  try
+  {
+    produce(dispatch);
+  }
+  catch (...)
+  {
+    finish();
+    throw;
+  }
+
+  finish();
+}
+
+// Picks range boundaries just past a newline near each multiple of the
+// target size.  Tokens never contain a newline, so none straddles two
+// ranges, and each range starts where the scanner expects a boundary.
+std::vector<ByteRange> split_at_newlines(const std::string& path, std::uint64_t size, std::size_t num_ranges)
+{
+  std::vector<ByteRange> ranges;
+  std::uint64_t begin = 0;
+  std::vector<char> buffer(64 * 1024);
+  for (std::size_t i = 1; i < num_ranges && begin < size; ++i)
+  {
+    auto target = std::max(begin, size / num_ranges * i);
+
+    FileSource source{path, ByteRange{target, size}};
+    auto end = size;
+    for (auto pos = target; ; )
+    {
+      auto n = source.read(buffer.data(), buffer.size());
+      if (n == 0)
+      {
+        break;
+      }
+      auto newline = static_cast<const char*>(std::memchr(buffer.data(), '\n', n));
+      if (newline != nullptr)
+      {
+        end = pos + static_cast<std::uint64_t>(newline - buffer.data()) + 1;
+        break;
+      }
+      pos += n;
+    }
+
+    if (end > begin)
+    {
+      ranges.push_back(ByteRange{begin, end});
+      begin = end;
+    }
+  }
+
+  if (begin < size)
+  {
+    ranges.push_back(ByteRange{begin, size});
+  }
+  return ranges;
+}
+
+// Splits a file for `num_threads` threads, or returns nothing if it is too
+// small to be worth splitting or there is only one thread to use, or if the
+// file is compressed.
+std::vector<ByteRange> plan_ranges(const std::string& path, std::uint64_t size, std::size_t num_threads)
+{
+  if (num_threads < 2 || size < 2 * kMinRangeSize || detect_file_compression(path) != Compression::None)
+  {
+    return {};
+  }
+
+  // A few ranges per thread even out lines that are slower to decode.
+  auto num_ranges = static_cast<std::size_t>(std::min<std::uint64_t>(num_threads * 4, size / kMinRangeSize));
+  return split_at_newlines(path, size, num_ranges);
+}
+
+} // anonymous namespace
+
+void scan_source(InputSource& source, const TokenCallback& on_token)
+{
+  jwt::TokenScanner scanner;
+  std::vector<char> buffer(kReadSize);
+  std::size_t filled = 0;
+
+  // Newlines are counted lazily, up to the latest token or the end of what
+  // the scanner consumed, whichever is later.
+  std::uint64_t buffer_offset = 0;
+  std::uint64_t counted_offset = 0;
+  std::uint64_t line = 1;
+  auto count_lines_to = [&](std::uint64_t offset) {
+    auto begin = buffer.data() + (counted_offset - buffer_offset);
+    auto end = buffer.data() + (offset - buffer_offset);
+    line += static_cast<std::uint64_t>(std::count(begin, end, '\n'));
+    counted_offset = offset;
+  };
+
+  auto on_scanned = [&](std::string_view text, std::uint64_t offset) {
+    count_lines_to(offset);
+    on_token(text, offset, line);
+  };
+
+  bool end_of_input = false;
+  while (!end_of_input)
+  {
+    if (buffer.size() - filled < kReadSize)
+    {
+      // Only a single enormous run can keep this many bytes unconsumed.
+      buffer.resize(filled + kReadSize);
+    }
+
+    std::size_t num_read;
+    {
+      jwt::ScopedPhase phase{jwt::Phase::Read};
+      num_read = source.read(buffer.data() + filled, buffer.size() - filled);
+      phase.add_bytes(num_read);
+    }
+
+    filled += num_read;
+    end_of_input = num_read == 0;
+
+    auto consumed = scanner.scan(std::string_view{buffer.data(), filled}, end_of_input, on_scanned);
+    count_lines_to(buffer_offset + consumed);
+
+    std::memmove(buffer.data(), buffer.data() + consumed, filled - consumed);
+    filled -= consumed;
+    buffer_offset += consumed;
+  }
+}
+
+void run_pipeline(InputSource& source, const PipelineOptions& options, const TokenPrinter& print)
+{
+  run_stages([&source](const BatchSink& dispatch) {
+    auto batch = std::make_unique<Batch>();
+    scan_source(source, [&](std::string_view text, std::uint64_t offset, std::uint64_t) {
+      batch->tokens.push_back(Batch::Token{batch->text.size(), text.size(), offset});
+      batch->text.append(text);
+
+      if (batch->tokens.size() == kBatchSize)
+      {
+        dispatch(std::move(batch));
+        batch = std::make_unique<Batch>();
+      }
+    });
+
+    if (!batch->tokens.empty())
+    {
+      dispatch(std::move(batch));
+    }
+  }, options, print);
+}
+
+void run_tokens(const std::vector<NotedToken>& tokens, const PipelineOptions& options, const TokenPrinter& print)
+{
+  run_stages([&tokens](const BatchSink& dispatch) {
+    for (std::size_t i = 0; i < tokens.size(); i += kBatchSize)
+    {
+      auto batch = std::make_unique<Batch>();
+      for (std::size_t j = i; j < std::min(i + kBatchSize, tokens.size()); ++j)
+      {
+        batch->tokens.push_back(Batch::Token{batch->text.size(), tokens[j].text.size(), 0});
+        batch->text.append(tokens[j].text);
+        batch->notes.push_back(Batch::Note{tokens[j].where, tokens[j].note});
+      }
+      dispatch(std::move(batch));
+    }
+  }, options, print);
+}
+
+void run_files(const std::vector<std::string>& paths, const PipelineOptions& options, const TokenPrinter& print)
+{
+  std::vector<std::unique_ptr<FileJob>> jobs;
+  for (const auto& path : paths)
+  {
+    jobs.push_back(std::make_unique<FileJob>());
+    jobs.back()->path = path;
+  }
+
+  auto num_threads = options.decoder_threads > 0 ? options.decoder_threads : ThreadPool::default_size();
+  run_jobs(jobs, num_threads, options, print);
+}
+
+void scan_files(const std::vector<std::string>& paths, const PipelineOptions& options, const SourceTokenCallback& on_token)
+{
+  struct Task
+  {
+    std::size_t source;
+    ByteRange range;
+    std::string error;
+  };
+
+  auto num_threads = options.decoder_threads > 0 ? options.decoder_threads : ThreadPool::default_size();
+
+  std::vector<Task> tasks;
+  if (paths.size() == 1)
+  {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(paths.front(), ec);
+    if (!ec)
+    {
+      for (const auto& range : plan_ranges(paths.front(), size, num_threads))
+      {
+        tasks.push_back(Task{0, range, {}});
+      }
+    }
+  }
+  const bool split = !tasks.empty();
+  if (!split)
+  {
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+      tasks.push_back(Task{i, ByteRange{}, {}});
+    }
+  }
+
+  {
+    ThreadPool pool{std::min(num_threads, std::max<std::size_t>(tasks.size(), 1)), "scanner"};
+    for (auto& task : tasks)
+    {
+      pool.submit([&task, &paths, &options, &on_token, split] {
+        jwt::ScopedSpan span{"file"};
+        const auto& path = paths[task.source];
+        try
+        {
+          auto source = open_input(path, options.use_io_uring, task.range);
+          scan_source(*source, [&](std::string_view text, std::uint64_t offset, std::uint64_t line) {
+            on_token(task.source, text, task.range.begin + offset, split ? 0 : line);
+          });
+        }
+        catch (const std::exception& ex)
+        {
+          // One unreadable file should not stop the others.
+          task.error = path + ": " + ex.what() + '\n';
+        }
+      });
+    }
+  }
+
+  for (const auto& task : tasks)
+  {
+    std::cerr << task.error;
+  }
+}
+
+bool run_split_file(const std::string& path, std::uint64_t size, const PipelineOptions& options, const TokenPrinter& print)
+{
+  auto num_threads = options.decoder_threads > 0 ? options.decoder_threads : ThreadPool::default_size();
+  auto ranges = plan_ranges(path, size, num_threads);
+  if (ranges.empty())
+  {
+    return false;
+  }
+
+  std::vector<std::unique_ptr<FileJob>> jobs;
+  for (const auto& range : ranges)
+  {
+    jobs.push_back(std::make_unique<FileJob>());
+    jobs.back()->path = path;
+    jobs.back()->range = range;
+    jobs.back()->labelled = false;
+  }
+
+  run_jobs(jobs, num_threads, options, print);
+  return true;
+}
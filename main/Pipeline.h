@@ -0,0 +1,113 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_PIPELINE_H
+#define JWT_MAIN_PIPELINE_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "libjwt/Decoder.h"
+#include "libjwt/Jwt.h"
+
+#include "InputSource.h"
+
+// Prints one decoded token, using the calling stage's Decoder.  Printing
+// nothing is fine; such tokens are left out of the output altogether.
+using TokenPrinter = std::function<void(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token)>;
+
+// Receives each token in a source with its byte offset and 1-based line.
+using TokenCallback = std::function<void(std::string_view token, std::uint64_t offset, std::uint64_t line)>;
+
+// Like TokenCallback, for several sources, identified by their index.
+using SourceTokenCallback = std::function<void(std::size_t source, std::string_view token, std::uint64_t offset, std::uint64_t line)>;
+
+// A token that was found earlier, with a line of text to print before it.
+struct NotedToken
+{
+  std::string_view text;
+
+  // Where it was found, for error messages, e.g. "a.log:3" or "offset 12".
+  std::string where;
+
+  std::string note;
+};
+
+struct PipelineOptions
+{
+  // Threads that decode and print tokens, or 0 to pick a default.  Output
+  // order never depends on it.
+  std::size_t decoder_threads {0};
+
+  bool use_io_uring {true};
+
+  // Whether tokens are set apart by blank lines and, from several files,
+  // labelled with their path and line.  Turn this off for formats that
+  // print one line per token.
+  bool separate_tokens {true};
+};
+
+// Reads `source` to the end on the calling thread, reporting every token.
+void scan_source(InputSource& source, const TokenCallback& on_token);
+
+// Finds, decodes and prints every token in `source`, overlapping input,
+// decoding and output.
+//
+// The calling thread reads and scans, handing batches of tokens round-robin
+// to the decoder threads through bounded lock-free queues; a writer thread
+// collects printed batches in the same round-robin order and writes them to
+// stdout, with skipped tokens reported on stderr.  When a queue is full its
+// producer waits, so a slow stage throttles the ones before it.
+//
+// Uses one decoder thread by default.
+void run_pipeline(InputSource& source, const PipelineOptions& options, const TokenPrinter& print);
+
+// Decodes and prints `tokens` in order, each after its note, on decoder
+// threads as in run_pipeline.  Tokens that fail to decode are reported with
+// their `where`.
+void run_tokens(const std::vector<NotedToken>& tokens, const PipelineOptions& options, const TokenPrinter& print);
+
+// Scans `paths` for tokens without decoding them, one task per file on a
+// thread pool, so `on_token` is called from several threads at once.  A
+// single big file is split into ranges as in run_split_file; its offsets
+// still count from the start of the file, but its lines are reported as 0.
+// Unreadable files are reported on stderr and skipped.
+void scan_files(const std::vector<std::string>& paths, const PipelineOptions& options, const SourceTokenCallback& on_token);
+
+// Finds, decodes and prints every token in `paths`, one task per file on a
+// shared thread pool (one thread per core by default).
+//
+// Output is written in the order of `paths`, streaming the earliest
+// unfinished file while later ones buffer a bounded amount; each token is
+// preceded by a "path:line" label.
+void run_files(const std::vector<std::string>& paths, const PipelineOptions& options, const TokenPrinter& print);
+
+// Like run_pipeline for a regular file of `size` bytes, but splits it into
+// newline-aligned ranges that are scanned on a thread pool and written back
+// in file order, so output is the same.  Returns false without doing
+// anything if the file is too small to be worth splitting or there is only
+// one thread to use, or if the file is compressed.
+bool run_split_file(const std::string& path, std::uint64_t size, const PipelineOptions& options, const TokenPrinter& print);
+
+#endif // JWT_MAIN_PIPELINE_H
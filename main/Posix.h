@@ -0,0 +1,79 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef JWT_MAIN_POSIX_H
+#define JWT_MAIN_POSIX_H
+
+#pragma once
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+// POSIX plumbing shared by the modes that run until stopped, --follow and
+// --serve.  Only for Linux builds.
+
+[[noreturn]] inline void throw_errno(const std::string& what)
+{
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Owns a file descriptor, closing it when replaced or destroyed.
+class FileDescriptor
+{
+public:
+  explicit FileDescriptor(int fd) : fd_(fd) {}
+  ~FileDescriptor() { reset(-1); }
+
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+  int get() const { return fd_; }
+
+  void reset(int fd)
+  {
+    if (fd_ != -1)
+    {
+      close(fd_);
+    }
+    fd_ = fd;
+  }
+
+private:
+  int fd_;
+};
+
+// Set by SIGINT and SIGTERM once handle_stop_signals() has been called, so
+// that a loop can check it and finish cleanly.
+inline volatile std::sig_atomic_t g_stop = 0;
+
+inline void handle_stop_signals()
+{
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = [](int) { g_stop = 1; };
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+}
+
+#endif // JWT_MAIN_POSIX_H
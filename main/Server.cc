@@ -0,0 +1,441 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Server.h"
+
+#include <stdexcept>
+
+#include "libjwt/config.h"
+
+#if defined(JWT_OS_LINUX)
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "libjwt/Decoder.h"
+#include "libjwt/Jwt.h"
+#include "libjwt/JwtError.h"
+
+#include "Posix.h"
+
+namespace {
+
+// Far larger than any sane token; anything bigger is a confused client.
+constexpr std::uint32_t kMaxRequestSize = 1 << 20;
+
+// Replies a client may leave unread before its requests stop being read.
+constexpr std::size_t kMaxPendingOutput = 4 << 20;
+
+
+struct Connection
+{
+  std::string input;
+  std::string output;
+  std::size_t output_pos {0};
+
+  // What the connection is registered with epoll for.
+  std::uint32_t events {EPOLLIN};
+
+  // The client has shut down its side; its requests so far are still
+  // answered.
+  bool peer_closed {false};
+
+  std::size_t pending() const { return output.size() - output_pos; }
+};
+
+jwt::ordered_json describe(const jwt::Jwt& token)
+{
+  jwt::ordered_json response;
+  response["header"] = token.header();
+  if (token.ciphertext().empty())
+  {
+    response["payload"] = token.payload();
+    response["signature"] = token.signature();
+  }
+  else
+  {
+    response["encrypted_key"] = token.encrypted_key();
+    response["initialization_vector"] = token.initialization_vector();
+    response["ciphertext"] = token.ciphertext();
+    response["authentication_tag"] = token.authentication_tag();
+  }
+  return response;
+}
+
+void append_frame(std::string& out, const std::string& body)
+{
+  auto size = static_cast<std::uint32_t>(body.size());
+  char prefix[4] = {
+    static_cast<char>(size >> 24),
+    static_cast<char>(size >> 16),
+    static_cast<char>(size >> 8),
+    static_cast<char>(size),
+  };
+  out.append(prefix, sizeof(prefix));
+  out += body;
+}
+
+class Server
+{
+public:
+  Server(const std::string& socket_path);
+  ~Server();
+
+  void run();
+
+private:
+  void accept_clients();
+  bool on_readable(int fd, Connection& connection);
+  bool on_writable(int fd, Connection& connection);
+  bool handle_requests(Connection& connection);
+  bool update_events(int fd, Connection& connection);
+  void handle_request(std::string_view request, std::string& output);
+
+  std::string socket_path_;
+  FileDescriptor listener_;
+  FileDescriptor epoll_;
+  std::unordered_map<int, Connection> connections_;
+
+  jwt::Decoder decoder_;
+  jwt::Jwt token_;
+  jwt::JwtError error_;
+};
+
+Server::Server(const std::string& socket_path)
+    : socket_path_(socket_path)
+    , listener_(socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0))
+    , epoll_(epoll_create1(EPOLL_CLOEXEC))
+{
+  if (listener_.get() == -1)
+  {
+    throw_errno("socket");
+  }
+  if (epoll_.get() == -1)
+  {
+    throw_errno("epoll_create1");
+  }
+
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path))
+  {
+    throw std::runtime_error("Socket path is too long: " + socket_path);
+  }
+  std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size());
+
+  // Replace a socket left behind by a previous run, but nothing else.
+  struct stat st;
+  if (lstat(socket_path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+  {
+    unlink(socket_path.c_str());
+  }
+
+  if (bind(listener_.get(), reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1)
+  {
+    throw_errno("bind");
+  }
+  if (listen(listener_.get(), SOMAXCONN) == -1)
+  {
+    throw_errno("listen");
+  }
+
+  epoll_event event {};
+  event.events = EPOLLIN;
+  event.data.fd = listener_.get();
+  if (epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, listener_.get(), &event) == -1)
+  {
+    throw_errno("epoll_ctl");
+  }
+}
+
+Server::~Server()
+{
+  for (auto& entry : connections_)
+  {
+    close(entry.first);
+  }
+  unlink(socket_path_.c_str());
+}
+
+void Server::run()
+{
+  constexpr int kMaxEvents = 64;
+  epoll_event events[kMaxEvents];
+
+  while (!g_stop)
+  {
+    int count = epoll_wait(epoll_.get(), events, kMaxEvents, -1);
+    if (count == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      throw_errno("epoll_wait");
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+      int fd = events[i].data.fd;
+      if (fd == listener_.get())
+      {
+        accept_clients();
+        continue;
+      }
+
+      auto it = connections_.find(fd);
+      if (it == connections_.end())
+      {
+        continue;
+      }
+
+      bool keep = !(events[i].events & (EPOLLERR | EPOLLHUP)) || (events[i].events & EPOLLIN);
+      if (keep && (events[i].events & EPOLLIN))
+      {
+        keep = on_readable(fd, it->second);
+      }
+      if (keep && (events[i].events & EPOLLOUT))
+      {
+        keep = on_writable(fd, it->second);
+      }
+
+      if (!keep)
+      {
+        epoll_ctl(epoll_.get(), EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections_.erase(it);
+      }
+    }
+  }
+}
+
+void Server::accept_clients()
+{
+  while (true)
+  {
+    int fd = accept4(listener_.get(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1)
+    {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+      {
+        return;
+      }
+      if (errno == ECONNABORTED || errno == EMFILE || errno == ENFILE)
+      {
+        std::cerr << "accept: " << std::strerror(errno) << std::endl;
+        return;
+      }
+      throw_errno("accept4");
+    }
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, fd, &event) == -1)
+    {
+      close(fd);
+      continue;
+    }
+    connections_.emplace(fd, Connection{});
+  }
+}
+
+bool Server::on_readable(int fd, Connection& connection)
+{
+  // Stop reading from a client that does not read its replies; update_events
+  // leaves EPOLLIN off until they drain.
+  char buffer[64 * 1024];
+  while (!connection.peer_closed && connection.pending() <= kMaxPendingOutput)
+  {
+    auto n = read(fd, buffer, sizeof(buffer));
+    if (n > 0)
+    {
+      connection.input.append(buffer, static_cast<std::size_t>(n));
+      if (!handle_requests(connection))
+      {
+        return false;
+      }
+      continue;
+    }
+    if (n == 0)
+    {
+      connection.peer_closed = true;
+      break;
+    }
+    if (errno == EINTR)
+    {
+      continue;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      break;
+    }
+    return false;
+  }
+
+  return on_writable(fd, connection);
+}
+
+// Answers every complete request in the connection's input.
+bool Server::handle_requests(Connection& connection)
+{
+  std::size_t pos = 0;
+  while (connection.input.size() - pos >= 4)
+  {
+    auto bytes = reinterpret_cast<const unsigned char*>(connection.input.data() + pos);
+    std::uint32_t size = (std::uint32_t{bytes[0]} << 24) | (std::uint32_t{bytes[1]} << 16)
+        | (std::uint32_t{bytes[2]} << 8) | std::uint32_t{bytes[3]};
+    if (size > kMaxRequestSize)
+    {
+      return false;
+    }
+    if (connection.input.size() - pos - 4 < size)
+    {
+      break;
+    }
+
+    handle_request(std::string_view{connection.input.data() + pos + 4, size}, connection.output);
+    pos += 4 + size;
+  }
+  connection.input.erase(0, pos);
+  return true;
+}
+
+bool Server::on_writable(int fd, Connection& connection)
+{
+  while (connection.pending() > 0)
+  {
+    auto n = send(fd,
+                  connection.output.data() + connection.output_pos,
+                  connection.pending(),
+                  MSG_NOSIGNAL);
+    if (n >= 0)
+    {
+      connection.output_pos += static_cast<std::size_t>(n);
+      continue;
+    }
+    if (errno == EINTR)
+    {
+      continue;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      break;
+    }
+    return false;
+  }
+
+  if (connection.pending() == 0)
+  {
+    connection.output.clear();
+    connection.output_pos = 0;
+  }
+
+  if (!update_events(fd, connection))
+  {
+    return false;
+  }
+
+  // A client may half-close after its last request; finish answering first.
+  return !connection.peer_closed || connection.pending() > 0;
+}
+
+// Only asks for EPOLLOUT while the socket buffer is full, and for EPOLLIN
+// while the client is keeping up with its replies and has not shut down its
+// side, at which point the socket would always be readable.
+bool Server::update_events(int fd, Connection& connection)
+{
+  std::uint32_t events = 0;
+  if (!connection.peer_closed && connection.pending() <= kMaxPendingOutput)
+  {
+    events |= EPOLLIN;
+  }
+  if (connection.pending() > 0)
+  {
+    events |= EPOLLOUT;
+  }
+
+  if (events == connection.events)
+  {
+    return true;
+  }
+  connection.events = events;
+
+  epoll_event event {};
+  event.events = events;
+  event.data.fd = fd;
+  return epoll_ctl(epoll_.get(), EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+void Server::handle_request(std::string_view request, std::string& output)
+{
+  // Segments are passed through as they are, so they need not be valid
+  // UTF-8; such bytes are replaced, and nothing about one request may bring
+  // the server down.
+  constexpr auto replace = jwt::ordered_json::error_handler_t::replace;
+  try
+  {
+    jwt::ordered_json response;
+    if (decoder_.try_parse_into(request, token_, error_))
+    {
+      response = describe(token_);
+    }
+    else
+    {
+      response["error"] = error_.message();
+      response["position"] = error_.position;
+    }
+    append_frame(output, response.dump(-1, ' ', false, replace));
+  }
+  catch (const std::exception& ex)
+  {
+    jwt::ordered_json response;
+    response["error"] = ex.what();
+    append_frame(output, response.dump(-1, ' ', false, replace));
+  }
+}
+
+} // anonymous namespace
+
+void serve(const std::string& socket_path)
+{
+  handle_stop_signals();
+
+  Server server{socket_path};
+  std::cerr << "Listening on " << socket_path << std::endl;
+  server.run();
+}
+
+#else
+
+void serve(const std::string&)
+{
+  throw std::runtime_error("--serve is only supported on Linux");
+}
+
+#endif
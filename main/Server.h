@@ -0,0 +1,38 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_SERVER_H
+#define JWT_MAIN_SERVER_H
+
+#pragma once
+
+#include <string>
+
+// Serves decode requests on a Unix domain socket until SIGINT or SIGTERM,
+// so that callers pay for process startup once rather than per token.
+//
+// Each request is a 4-byte big-endian length followed by that many bytes of
+// token.  Each response is framed the same way and holds a JSON object,
+// either {"header":...,"payload":...,"signature":...} or
+// {"error":...,"position":...}.  Responses come back in request order.
+//
+// All clients are multiplexed with epoll on a single thread; decoding a
+// token takes microseconds, so a worker pool would mostly add handoffs.
+// Linux only; elsewhere this throws.
+void serve(const std::string& socket_path);
+
+#endif // JWT_MAIN_SERVER_H
@@ -0,0 +1,139 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_SPSCQUEUE_H
+#define JWT_MAIN_SPSCQUEUE_H
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A bounded, lock-free queue for exactly one producer thread and one
+// consumer thread.
+//
+// Each side caches the other's index and only reloads it when the queue
+// looks full (or empty), so in the steady state a push or pop touches no
+// cache line the other thread is writing.
+template <typename T>
+class SpscQueue
+{
+public:
+  // Capacity is rounded up to a power of two.
+  explicit SpscQueue(std::size_t capacity)
+      : slots_(round_up(capacity))
+      , mask_(slots_.size() - 1)
+  {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  bool try_push(T& value)
+  {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == slots_.size())
+    {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == slots_.size())
+      {
+        return false;
+      }
+    }
+
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T& value)
+  {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_)
+    {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_)
+      {
+        return false;
+      }
+    }
+
+    value = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Blocking variants, which back off from spinning to sleeping so that an
+  // idle stage, e.g. one waiting on a slow pipe, does not burn a core.
+  void push(T value)
+  {
+    for (unsigned attempt = 0; !try_push(value); ++attempt)
+    {
+      back_off(attempt);
+    }
+  }
+
+  T pop()
+  {
+    T value;
+    for (unsigned attempt = 0; !try_pop(value); ++attempt)
+    {
+      back_off(attempt);
+    }
+    return value;
+  }
+
+private:
+  static std::size_t round_up(std::size_t n)
+  {
+    std::size_t capacity = 1;
+    while (capacity < n)
+    {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  static void back_off(unsigned attempt)
+  {
+    if (attempt < 64)
+    {
+      std::this_thread::yield();
+    }
+    else
+    {
+      auto micros = attempt < 128 ? 50 : 1000;
+      std::this_thread::sleep_for(std::chrono::microseconds{micros});
+    }
+  }
+
+  std::vector<T> slots_;
+  const std::size_t mask_;
+
+  // Consumer side.
+  alignas(64) std::atomic<std::size_t> head_ {0};
+  std::size_t tail_cache_ {0};
+
+  // Producer side.
+  alignas(64) std::atomic<std::size_t> tail_ {0};
+  std::size_t head_cache_ {0};
+};
+
+#endif // JWT_MAIN_SPSCQUEUE_H
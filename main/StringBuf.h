@@ -0,0 +1,55 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_STRINGBUF_H
+#define JWT_MAIN_STRINGBUF_H
+
+#pragma once
+
+#include <streambuf>
+#include <string>
+
+// An ostream target that appends to a string, reusing its capacity.  It
+// buffers nothing itself, so the string is always up to date.
+class StringBuf : public std::streambuf
+{
+public:
+  explicit StringBuf(std::string& target) : target_(&target) {}
+
+  void reset(std::string& target) { target_ = &target; }
+
+protected:
+  int overflow(int c) override
+  {
+    if (c != traits_type::eof())
+    {
+      target_->push_back(static_cast<char>(c));
+    }
+    return c;
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    target_->append(s, static_cast<std::size_t>(n));
+    return n;
+  }
+
+private:
+  std::string* target_;
+};
+
+#endif // JWT_MAIN_STRINGBUF_H
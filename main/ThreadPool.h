@@ -0,0 +1,66 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_THREADPOOL_H
+#define JWT_MAIN_THREADPOOL_H
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads running tasks in submission order.
+//
+// Tasks are expected to be coarse, e.g. a whole file, so a plain locked
+// queue is cheap enough.  Tasks must not throw.
+class ThreadPool
+{
+public:
+  // `name` labels the workers in --trace output, e.g. "worker 3".
+  ThreadPool(std::size_t num_threads, std::string name);
+
+  // Runs every task already submitted, then joins the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void submit(std::function<void()> task);
+
+  std::size_t size() const { return workers_.size(); }
+
+  // The number of threads to use when the user did not say.
+  static std::size_t default_size();
+
+private:
+  void work(std::size_t index);
+
+  std::string name_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_ {false};
+  std::vector<std::thread> workers_;
+};
+
+#endif // JWT_MAIN_THREADPOOL_H
@@ -0,0 +1,376 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "UringSource.h"
+
+#if defined(JWT_HAVE_IO_URING)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "libjwt/InputError.h"
+
+namespace {
+
+constexpr unsigned kNumBuffers = 8;
+constexpr std::uint32_t kBufferSize = 256 * 1024;
+
+int io_uring_setup(unsigned entries, io_uring_params* params)
+{
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int ring, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int ring, unsigned opcode, const void* arg, unsigned nr_args)
+{
+  return static_cast<int>(syscall(__NR_io_uring_register, ring, opcode, arg, nr_args));
+}
+
+template <typename T>
+T* at(void* base, std::uint32_t offset)
+{
+  return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // anonymous namespace
+
+// The kernel-shared rings and the buffers registered with them.
+struct UringSource::Ring
+{
+  ~Ring()
+  {
+    if (sqes != nullptr) munmap(sqes, sqes_size);
+    if (cq_ptr != nullptr && cq_ptr != sq_ptr) munmap(cq_ptr, cq_size);
+    if (sq_ptr != nullptr) munmap(sq_ptr, sq_size);
+    if (fd != -1) close(fd);
+    std::free(buffers);
+  }
+
+  bool init()
+  {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    fd = io_uring_setup(kNumBuffers, &params);
+    if (fd == -1)
+    {
+      return false;
+    }
+
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+    {
+      sq_size = cq_size = std::max(sq_size, cq_size);
+    }
+
+    sq_ptr = map(sq_size, IORING_OFF_SQ_RING);
+    cq_ptr = single_mmap ? sq_ptr : map(cq_size, IORING_OFF_CQ_RING);
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe*>(map(sqes_size, IORING_OFF_SQES));
+    if (sq_ptr == nullptr || cq_ptr == nullptr || sqes == nullptr)
+    {
+      return false;
+    }
+
+    sq_tail = at<unsigned>(sq_ptr, params.sq_off.tail);
+    sq_mask = *at<unsigned>(sq_ptr, params.sq_off.ring_mask);
+    sq_array = at<unsigned>(sq_ptr, params.sq_off.array);
+    cq_head = at<unsigned>(cq_ptr, params.cq_off.head);
+    cq_tail = at<unsigned>(cq_ptr, params.cq_off.tail);
+    cq_mask = *at<unsigned>(cq_ptr, params.cq_off.ring_mask);
+    cqes = at<io_uring_cqe>(cq_ptr, params.cq_off.cqes);
+
+    // Registered buffers are pinned once, instead of on every read.  This
+    // fails if RLIMIT_MEMLOCK is tiny, in which case we fall back entirely.
+    if (posix_memalign(&buffers, 4096, std::size_t{kNumBuffers} * kBufferSize) != 0)
+    {
+      buffers = nullptr;
+      return false;
+    }
+
+    iovec iovecs[kNumBuffers];
+    for (unsigned i = 0; i < kNumBuffers; ++i)
+    {
+      iovecs[i].iov_base = buffer(i);
+      iovecs[i].iov_len = kBufferSize;
+    }
+    return io_uring_register(fd, IORING_REGISTER_BUFFERS, iovecs, kNumBuffers) == 0;
+  }
+
+  void* map(std::size_t size, off_t offset)
+  {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return p == MAP_FAILED ? nullptr : p;
+  }
+
+  char* buffer(unsigned index)
+  {
+    return static_cast<char*>(buffers) + std::size_t{index} * kBufferSize;
+  }
+
+  int fd {-1};
+
+  void* sq_ptr {nullptr};
+  std::size_t sq_size {0};
+  void* cq_ptr {nullptr};
+  std::size_t cq_size {0};
+  io_uring_sqe* sqes {nullptr};
+  std::size_t sqes_size {0};
+
+  unsigned* sq_tail {nullptr};
+  unsigned sq_mask {0};
+  unsigned* sq_array {nullptr};
+  unsigned* cq_head {nullptr};
+  unsigned* cq_tail {nullptr};
+  unsigned cq_mask {0};
+  io_uring_cqe* cqes {nullptr};
+
+  void* buffers {nullptr};
+};
+
+thread_local std::unique_ptr<UringSource::Ring> UringSource::spare_ring_;
+
+std::unique_ptr<UringSource> UringSource::open(const std::string& path, ByteRange range)
+{
+  int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file == -1)
+  {
+    throw jwt::InputError{"Could not open " + path};
+  }
+
+  struct stat st;
+  if (fstat(file, &st) != 0 || !S_ISREG(st.st_mode))
+  {
+    close(file);
+    return nullptr;
+  }
+
+  auto ring = std::move(spare_ring_);
+  if (!ring)
+  {
+    ring = std::make_unique<Ring>();
+    if (!ring->init())
+    {
+      close(file);
+      return nullptr;
+    }
+  }
+
+  range.end = std::min(range.end, static_cast<std::uint64_t>(st.st_size));
+  range.begin = std::min(range.begin, range.end);
+  return std::unique_ptr<UringSource>{new UringSource{file, range, std::move(ring)}};
+}
+
+UringSource::UringSource(int file, ByteRange range, std::unique_ptr<Ring> ring)
+    : file_(file)
+    , end_offset_(range.end)
+    , next_offset_(range.begin)
+    , ring_(std::move(ring))
+    , slots_(kNumBuffers)
+{
+  for (std::size_t i = 0; i < slots_.size() && next_offset_ < end_offset_; ++i)
+  {
+    slots_[i].offset = next_offset_;
+    slots_[i].length = static_cast<std::uint32_t>(std::min<std::uint64_t>(kBufferSize, end_offset_ - next_offset_));
+    next_offset_ += slots_[i].length;
+    queue_read(i);
+  }
+  submit_and_wait(0);
+}
+
+UringSource::~UringSource()
+{
+  // The kernel may still be writing into our buffers; let it finish.
+  try
+  {
+    while (std::any_of(slots_.begin(), slots_.end(), [](const Slot& s) { return s.in_flight; }))
+    {
+      submit_and_wait(1);
+    }
+  }
+  catch (const jwt::InputError&)
+  {
+    // Closing the ring below cancels whatever is left.
+    close(file_);
+    return;
+  }
+  close(file_);
+
+  // Every read has completed, so the ring is idle and can serve another file.
+  if (!spare_ring_)
+  {
+    spare_ring_ = std::move(ring_);
+  }
+}
+
+void UringSource::queue_read(std::size_t index)
+{
+  auto& slot = slots_[index];
+  auto tail = *ring_->sq_tail;
+  auto sq_index = tail & ring_->sq_mask;
+
+  auto& sqe = ring_->sqes[sq_index];
+  std::memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_READ_FIXED;
+  sqe.fd = file_;
+  sqe.off = slot.offset;
+  sqe.addr = reinterpret_cast<std::uint64_t>(ring_->buffer(static_cast<unsigned>(index)) + slot.consumed);
+  sqe.len = slot.length;
+  sqe.buf_index = static_cast<std::uint16_t>(index);
+  sqe.user_data = index;
+
+  ring_->sq_array[sq_index] = sq_index;
+  __atomic_store_n(ring_->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  slot.in_flight = true;
+  slot.done = false;
+  ++unsubmitted_;
+}
+
+void UringSource::submit_and_wait(unsigned min_complete)
+{
+  while (true)
+  {
+    int rc = io_uring_enter(ring_->fd, unsubmitted_, min_complete, min_complete > 0 ? IORING_ENTER_GETEVENTS : 0);
+    if (rc >= 0)
+    {
+      unsubmitted_ -= static_cast<unsigned>(rc);
+      break;
+    }
+    if (errno != EINTR)
+    {
+      throw jwt::InputError{std::string{"io_uring_enter failed: "} + std::strerror(errno)};
+    }
+  }
+
+  auto head = *ring_->cq_head;
+  auto tail = __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head)
+  {
+    const auto& cqe = ring_->cqes[head & ring_->cq_mask];
+    auto& slot = slots_[cqe.user_data];
+    slot.result = cqe.res;
+    slot.in_flight = false;
+    slot.done = true;
+  }
+  __atomic_store_n(ring_->cq_head, head, __ATOMIC_RELEASE);
+}
+
+std::size_t UringSource::read(char* buffer, std::size_t size)
+{
+  auto& slot = slots_[current_];
+  if (!slot.in_flight && !slot.done)
+  {
+    return 0;
+  }
+
+  // Reads complete in any order; waiting for one may well reap another.
+  while (!slot.done)
+  {
+    submit_and_wait(1);
+  }
+
+  if (slot.result < 0)
+  {
+    throw jwt::InputError{std::string{"Error reading input: "} + std::strerror(-slot.result)};
+  }
+
+  auto result = static_cast<std::uint32_t>(slot.result);
+  if (result == 0)
+  {
+    // The file shrank under us; treat it as the end.
+    slot.done = false;
+    return 0;
+  }
+
+  auto* data = ring_->buffer(static_cast<unsigned>(current_));
+  auto n = std::min<std::size_t>(size, result - slot.consumed);
+  std::memcpy(buffer, data + slot.consumed, n);
+  slot.consumed += static_cast<std::uint32_t>(n);
+
+  if (slot.consumed < result)
+  {
+    return n;
+  }
+
+  if (result < slot.length)
+  {
+    // A short read: fetch the rest of this range before moving on, so that
+    // chunks stay in file order.
+    slot.offset += result;
+    slot.length -= result;
+  }
+  else if (next_offset_ < end_offset_)
+  {
+    slot.offset = next_offset_;
+    slot.length = static_cast<std::uint32_t>(std::min<std::uint64_t>(kBufferSize, end_offset_ - next_offset_));
+    next_offset_ += slot.length;
+    current_ = (current_ + 1) % slots_.size();
+  }
+  else
+  {
+    slot.done = false;
+    current_ = (current_ + 1) % slots_.size();
+    return n;
+  }
+
+  slot.consumed = 0;
+  queue_read(static_cast<std::size_t>(&slot - slots_.data()));
+
+  // Submit refills in batches, so that a syscall covers several chunks.
+  if (unsubmitted_ >= kNumBuffers / 2)
+  {
+    submit_and_wait(0);
+  }
+
+  return n;
+}
+
+#else
+
+struct UringSource::Ring {};
+
+thread_local std::unique_ptr<UringSource::Ring> UringSource::spare_ring_;
+
+std::unique_ptr<UringSource> UringSource::open(const std::string&, ByteRange)
+{
+  return nullptr;
+}
+
+UringSource::~UringSource() = default;
+
+std::size_t UringSource::read(char*, std::size_t)
+{
+  return 0;
+}
+
+#endif
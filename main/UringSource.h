@@ -0,0 +1,86 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JWT_MAIN_URINGSOURCE_H
+#define JWT_MAIN_URINGSOURCE_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "InputSource.h"
+
+// Reads a regular file through io_uring, keeping several reads into
+// registered buffers in flight so that the next chunks are usually ready
+// before they are asked for.  Submissions are batched, so most calls to
+// read() just copy out of a completed buffer without a syscall.  Setting up
+// a ring and registering its buffers costs far more than reading a small
+// file, so each thread keeps its last ring for the next file it opens.
+//
+// Talks to the kernel directly rather than through liburing.  Only built on
+// Linux when <linux/io_uring.h> is available (JWT_HAVE_IO_URING).
+class UringSource : public InputSource
+{
+public:
+  // Returns null if io_uring cannot be used here, e.g. on an old kernel,
+  // under a seccomp policy that forbids it, or for a pipe, so that the
+  // caller can fall back to FileSource.
+  static std::unique_ptr<UringSource> open(const std::string& path, ByteRange range = {});
+
+  ~UringSource() override;
+
+  UringSource(const UringSource&) = delete;
+  UringSource& operator=(const UringSource&) = delete;
+
+  std::size_t read(char* buffer, std::size_t size) override;
+
+private:
+  struct Slot
+  {
+    std::uint64_t offset {0};
+    std::uint32_t length {0};
+    std::int32_t result {0};
+    std::uint32_t consumed {0};
+    bool in_flight {false};
+    bool done {false};
+  };
+
+  struct Ring;
+
+  UringSource(int file, ByteRange range, std::unique_ptr<Ring> ring);
+
+  // The ring a finished source leaves behind for this thread's next one.
+  static thread_local std::unique_ptr<Ring> spare_ring_;
+
+  void queue_read(std::size_t index);
+  void submit_and_wait(unsigned min_complete);
+
+  int file_;
+  std::uint64_t end_offset_;
+  std::uint64_t next_offset_;
+
+  std::unique_ptr<Ring> ring_;
+  std::vector<Slot> slots_;
+  std::size_t current_ {0};
+  unsigned unsubmitted_ {0};
+};
+
+#endif // JWT_MAIN_URINGSOURCE_H
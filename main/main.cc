@@ -15,21 +15,52 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
 
 #include "libjwt/config.h"
+#include "libjwt/BinaryFormat.h"
+#include "libjwt/ClaimIndex.h"
+#include "libjwt/ClaimSummary.h"
+#include "libjwt/ClaimTable.h"
+#include "libjwt/Decoder.h"
+#include "libjwt/DistinctTokens.h"
 #include "libjwt/InputError.h"
 #include "libjwt/JsonPrinter.h"
 #include "libjwt/Jwt.h"
+#include "libjwt/RowFormatter.h"
+#include "libjwt/Stats.h"
+#include "libjwt/TimeHistogram.h"
+#include "libjwt/TokenScanner.h"
+#include "libjwt/Trace.h"
+
+#include "Follow.h"
+#include "Index.h"
+#include "InputSource.h"
+#include "Inputs.h"
+#include "MappedFile.h"
+#include "PerThread.h"
+#include "Pipeline.h"
+#include "Server.h"
 
 #if defined(JWT_OS_WIN)
+#  include <fcntl.h>
 #  include <io.h>
 #  define isatty(x) _isatty(x)
 #  define STDIN_FILENO 0
@@ -52,16 +83,120 @@ public:
   {}
 };
 
+// Matches "--name VALUE" as well as "--name=VALUE", consuming the value.
+bool option_with_value(const char* name, int argc, char** argv, int& i, std::string& value)
+{
+  auto length = strlen(name);
+  if (strncmp(name, argv[i], length) != 0)
+  {
+    return false;
+  }
+
+  if (argv[i][length] == '=')
+  {
+    value = argv[i] + length + 1;
+    return true;
+  }
+  if (argv[i][length] != '\0')
+  {
+    return false;
+  }
+
+  if (i == argc - 1)
+  {
+    throw UsageError(std::string{name} + " requires a value");
+  }
+  value = argv[++i];
+  return true;
+}
+
+std::vector<std::string> split_list(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::size_t start = 0;
+  while (start <= list.size())
+  {
+    auto end = std::min(list.find(',', start), list.size());
+    if (end > start)
+    {
+      items.push_back(list.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return items;
+}
+
+// Binary output must reach stdout byte for byte; on Windows, stdout is in
+// text mode and would turn every LF into CRLF.
+void set_binary_stdout()
+{
+#if defined(JWT_OS_WIN)
+  std::cout.flush();
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+}
+
 void usage()
 {
   std::string lines[] = {
     "Parses and displays encoded JWT tokens.",
     "",
-    "jwt_dump [-h|--help] [-H|--header] [-p|--payload]",
+    "jwt_dump [-h|--help] [-H|--header] [-p|--payload] [token]",
+    "jwt_dump -x|--extract [-H|--header] [-p|--payload] [file|dir|glob ...]",
+    "jwt_dump -f|--follow [--state FILE] [-H|--header] [-p|--payload] file",
+    "jwt_dump --query FILE [--format tsv|csv] [--columns LIST] [condition ...]",
+    "jwt_dump --index build INDEX file|dir|glob ...",
+    "jwt_dump --index query INDEX [-H|--header] [-p|--payload] [--format tsv|csv] [condition ...]",
+    "jwt_dump --serve SOCKET",
     "",
     "  -h OR --help              Displays this message.",
     "  -H OR --print-header      Displays the JWT header.",
     "  -p OR --print-payload     Displays the JWT payload.",
+    "  -x OR --extract           Finds and displays every token in a file,",
+    "                            such as an access log.  Given several files,",
+    "                            directories or globs, scans them in parallel",
+    "                            and labels each token with its file and line.",
+    "  -f OR --follow            Finds and displays every token in a file, then",
+    "                            keeps displaying new ones as lines are appended",
+    "                            to it, like tail -F, until stopped.",
+    "  -j OR --jobs N            Decodes with N threads when extracting.",
+    "      --aggregate           Instead of each token, prints statistics about",
+    "                            them all: counts by algorithm, key and issuer,",
+    "                            distinct and top subjects, and lifetimes.",
+    "                            Implies -x unless --follow is given.",
+    "      --columns LIST        With --format tsv or csv, the comma-separated",
+    "                            claims to display, e.g. iss,sub,exp,kid.",
+    "                            Claims are looked up in the payload, then the",
+    "                            header; prefix header. or payload. to choose.",
+    "      --format FORMAT       Displays tokens as pretty JSON (the default),",
+    "                            or one row per token of tsv or csv.  cbor and",
+    "                            msgpack write each token as a 4-byte big-endian",
+    "                            length and a map like --serve's responses.",
+    "                            claims writes a binary claim table for --query.",
+    "      --histogram UNIT      Instead of each token, prints how many tokens",
+    "                            each issuer issued, and how many expire, per",
+    "                            minute, hour or day (UTC).  Implies -x likewise.",
+    "      --index build|query   Decodes files once into INDEX, which points",
+    "                            back into them sorted by iss, sub and exp; or",
+    "                            looks up the tokens in INDEX that match every",
+    "                            condition: iss=X, sub=Y, or comparisons of",
+    "                            exp.  Displays the tokens, or with --format",
+    "                            tsv or csv, where they are.",
+    "      --no-io-uring         Reads files with plain read() calls.",
+    "      --query FILE          Displays the rows of a claim table that match",
+    "                            every condition, e.g. iss=https://a or",
+    "                            exp>=1792317600, as tsv or csv.  Strings",
+    "                            compare with = and !=, and iat, nbf and exp",
+    "                            also with <, <=, > and >=.",
+    "      --serve SOCKET        Decodes length-prefixed tokens sent to a Unix",
+    "                            socket, replying with JSON, until stopped.",
+    "      --state FILE          With --follow, records how far the file has",
+    "                            been read in FILE, and resumes from there.",
+    "      --stats               Prints per-phase timings to stderr at exit.",
+    "      --trace FILE          Writes a Chrome trace of every phase to FILE.",
+    "      --uniq                Displays each distinct token once, in order of",
+    "                            first appearance, with how often it occurs.",
+    "                            Implies -x.",
     "",
     "If no options are given, all parts of the token are displayed.",
     "Tokens may also be piped via stdin."
@@ -81,26 +216,78 @@ public:
   void run();
 
 private:
-  void print_header(const jwt::Jwt& token) const;
-  void print_payload(const jwt::Jwt& token) const;
-  void print_everything(const jwt::Jwt& token) const;
-  void print_raw_json() const;
+  void print_token(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const;
+  void print_header(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const;
+  void print_payload(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const;
+  void print_everything(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const;
+  void print_raw_json();
+
+  void extract_tokens();
+  void write_claim_table();
+  void query_claim_table();
+  void query_index();
+  void scan_inputs(const TokenPrinter& print);
+  void print_distinct_tokens(const TokenPrinter& print);
+
+  template <typename Summary>
+  void summarize(const typename PerThread<Summary>::Factory& make);
+  void flush_output();
 
 private:
   std::string input;
+  std::vector<std::string> input_paths;
+  std::string socket_path;
+  bool follow_input;
+  bool aggregate_claims;
+  std::int64_t histogram_seconds;
+  bool unique_tokens;
+  std::unique_ptr<jwt::RowFormatter> row_formatter;
+  bool write_claims;
+  bool write_binary;
+  jwt::BinaryFormat binary_format;
+  std::string query_path;
+  std::vector<jwt::ClaimColumn> query_columns;
+  std::vector<jwt::ClaimCondition> query_conditions;
+  std::string index_action;
+  std::string index_path;
+  std::string state_path;
   bool use_ansi_colors;
 
+  jwt::Decoder decoder;
+  PipelineOptions pipeline_options;
+
+  std::chrono::steady_clock::time_point start_time;
+  std::unique_ptr<jwt::Stats> stats;
+  std::unique_ptr<jwt::Trace> trace;
+  std::string trace_path;
+
   enum ProgramMode {
     modeDefault = 0,
     modeHeader = 1,
     modePayload = 2,
-    modeRawJson = 4
+    modeRawJson = 4,
+    modeExtract = 8,
+    modeServe = 16,
+    modeQuery = 32,
+    modeIndex = 64
   } mode;
 };
 
 Program::Program(int argc, char** argv)
 {
+  std::vector<std::string> positional;
+  std::string format = "pretty";
+  std::string columns;
+
   mode = modeDefault;
+  follow_input = false;
+  aggregate_claims = false;
+  histogram_seconds = 0;
+  unique_tokens = false;
+  write_claims = false;
+  write_binary = false;
+  binary_format = jwt::BinaryFormat::Cbor;
+  start_time = std::chrono::steady_clock::now();
 
   for (int i = 1; i < argc; ++i)
   {
@@ -130,18 +317,356 @@ Program::Program(int argc, char** argv)
       continue;
     }
 
-    if (i == argc - 1)
+    if (strcmp("-x", opt) == 0 || strcmp("--extract", opt) == 0)
     {
-      input = std::string{opt};
+      mode = static_cast<ProgramMode>(mode | modeExtract);
+      continue;
     }
-    else
+
+    if (strcmp("-f", opt) == 0 || strcmp("--follow", opt) == 0)
+    {
+      mode = static_cast<ProgramMode>(mode | modeExtract);
+      follow_input = true;
+      continue;
+    }
+
+    if (strcmp("-j", opt) == 0 || strcmp("--jobs", opt) == 0)
+    {
+      if (i == argc - 1)
+      {
+        throw UsageError("--jobs requires a thread count");
+      }
+
+      char* end;
+      auto jobs = std::strtoul(argv[++i], &end, 10);
+      if (*end != '\0' || jobs == 0 || jobs > 256)
+      {
+        throw UsageError("--jobs must be between 1 and 256");
+      }
+      pipeline_options.decoder_threads = jobs;
+      continue;
+    }
+
+    if (option_with_value("--format", argc, argv, i, format) || option_with_value("--columns", argc, argv, i, columns))
+    {
+      continue;
+    }
+
+    if (strcmp("--aggregate", opt) == 0)
+    {
+      mode = static_cast<ProgramMode>(mode | modeExtract);
+      aggregate_claims = true;
+      continue;
+    }
+
+    if (strcmp("--histogram", opt) == 0)
+    {
+      if (i == argc - 1)
+      {
+        throw UsageError("--histogram requires a unit of time");
+      }
+
+      std::string_view unit = argv[++i];
+      if (unit == "minute")
+      {
+        histogram_seconds = jwt::TimeHistogram::kMinute;
+      }
+      else if (unit == "hour")
+      {
+        histogram_seconds = jwt::TimeHistogram::kHour;
+      }
+      else if (unit == "day")
+      {
+        histogram_seconds = jwt::TimeHistogram::kDay;
+      }
+      else
+      {
+        throw UsageError("--histogram must be minute, hour or day");
+      }
+
+      mode = static_cast<ProgramMode>(mode | modeExtract);
+      continue;
+    }
+
+    if (option_with_value("--index", argc, argv, i, index_action))
+    {
+      if (index_action != "build" && index_action != "query")
+      {
+        throw UsageError("--index must be build or query");
+      }
+      mode = static_cast<ProgramMode>(mode | modeIndex);
+      continue;
+    }
+
+    if (strcmp("--no-io-uring", opt) == 0)
+    {
+      pipeline_options.use_io_uring = false;
+      continue;
+    }
+
+    if (option_with_value("--query", argc, argv, i, query_path))
+    {
+      mode = static_cast<ProgramMode>(mode | modeQuery);
+      continue;
+    }
+
+    if (strcmp("--serve", opt) == 0)
+    {
+      if (i == argc - 1)
+      {
+        throw UsageError("--serve requires a socket path");
+      }
+
+      mode = static_cast<ProgramMode>(mode | modeServe);
+      socket_path = argv[++i];
+      continue;
+    }
+
+    if (strcmp("--state", opt) == 0)
+    {
+      if (i == argc - 1)
+      {
+        throw UsageError("--state requires a file name");
+      }
+
+      state_path = argv[++i];
+      continue;
+    }
+
+    if (strcmp("--stats", opt) == 0)
+    {
+      if (!stats)
+      {
+        stats = std::make_unique<jwt::Stats>();
+        jwt::set_stats(stats.get());
+      }
+      continue;
+    }
+
+    if (strcmp("--trace", opt) == 0)
+    {
+      if (i == argc - 1)
+      {
+        throw UsageError("--trace requires a file name");
+      }
+
+      trace_path = argv[++i];
+      if (!trace)
+      {
+        trace = std::make_unique<jwt::Trace>();
+        jwt::set_trace(trace.get());
+        trace->set_thread_name("main");
+      }
+      continue;
+    }
+
+    if (strcmp("--uniq", opt) == 0)
+    {
+      mode = static_cast<ProgramMode>(mode | modeExtract);
+      unique_tokens = true;
+      continue;
+    }
+
+    if (opt[0] == '-')
     {
       throw InvalidOptionError(opt);
     }
+
+    positional.push_back(opt);
+  }
+
+  use_ansi_colors = isatty(STDOUT_FILENO);
+
+  if (!state_path.empty() && !follow_input)
+  {
+    throw UsageError("--state requires --follow");
+  }
+
+  if (aggregate_claims && histogram_seconds > 0)
+  {
+    throw UsageError("--aggregate and --histogram cannot be combined");
+  }
+
+  if (unique_tokens && (follow_input || aggregate_claims || histogram_seconds > 0))
+  {
+    throw UsageError("--uniq cannot be combined with --follow, --aggregate or --histogram");
+  }
+
+  if (mode & modeIndex)
+  {
+    if (mode & ~(modeIndex | modeHeader | modePayload))
+    {
+      throw UsageError("--index cannot be combined with other modes");
+    }
+    if (positional.empty())
+    {
+      throw UsageError("--index " + index_action + " requires an index file");
+    }
+    index_path = positional.front();
+    positional.erase(positional.begin());
+
+    if (index_action == "build")
+    {
+      if (positional.empty())
+      {
+        throw UsageError("--index build requires files to index");
+      }
+      if (format != "pretty")
+      {
+        throw UsageError("--index build cannot be combined with --format");
+      }
+      input_paths = std::move(positional);
+      return;
+    }
+
+    try
+    {
+      for (const auto& condition : positional)
+      {
+        query_conditions.push_back(jwt::ClaimCondition::parse(condition));
+      }
+    }
+    catch (const jwt::InputError& ex)
+    {
+      throw UsageError(ex.what());
+    }
+
+    // Rows say where each token is, rather than what is in it.
+    if (format == "tsv" || format == "csv")
+    {
+      auto row_format = format == "tsv" ? jwt::RowFormatter::Format::Tsv : jwt::RowFormatter::Format::Csv;
+      row_formatter = std::make_unique<jwt::RowFormatter>(row_format, std::vector<std::string>{"iss", "sub", "exp", "path", "line", "offset"});
+    }
+    else if (format != "pretty")
+    {
+      throw UsageError("--index query displays tokens, or rows of tsv or csv");
+    }
+    return;
+  }
+
+  if (mode & modeQuery)
+  {
+    // A claim table is displayed as rows; all of its columns by default.
+    if (mode & ~modeQuery)
+    {
+      throw UsageError("--query cannot be combined with other modes");
+    }
+    if (format != "pretty" && format != "tsv" && format != "csv")
+    {
+      throw UsageError("--query displays rows of tsv or csv");
+    }
+    if (columns.empty())
+    {
+      for (std::size_t i = 0; i < jwt::kClaimColumnCount; ++i)
+      {
+        columns += (i > 0 ? "," : "") + std::string{jwt::column_name(static_cast<jwt::ClaimColumn>(i))};
+      }
+    }
+
+    for (const auto& name : split_list(columns))
+    {
+      jwt::ClaimColumn column;
+      if (!jwt::find_column(name, column))
+      {
+        throw UsageError("A claim table has no column " + name);
+      }
+      query_columns.push_back(column);
+    }
+
+    try
+    {
+      for (const auto& condition : positional)
+      {
+        query_conditions.push_back(jwt::ClaimCondition::parse(condition));
+      }
+    }
+    catch (const jwt::InputError& ex)
+    {
+      throw UsageError(ex.what());
+    }
+
+    auto row_format = format == "csv" ? jwt::RowFormatter::Format::Csv : jwt::RowFormatter::Format::Tsv;
+    row_formatter = std::make_unique<jwt::RowFormatter>(row_format, split_list(columns));
+    return;
+  }
+
+  if (format == "tsv" || format == "csv")
+  {
+    if (aggregate_claims || histogram_seconds > 0 || unique_tokens)
+    {
+      throw UsageError("--format " + format + " cannot be combined with --aggregate, --histogram or --uniq");
+    }
+
+    auto row_format = format == "tsv" ? jwt::RowFormatter::Format::Tsv : jwt::RowFormatter::Format::Csv;
+    row_formatter = std::make_unique<jwt::RowFormatter>(row_format, split_list(columns.empty() ? "alg,kid,iss,sub,aud,iat,exp,jti" : columns));
+
+    // Rows follow one another directly.
+    pipeline_options.separate_tokens = false;
+  }
+  else if (format == "cbor" || format == "msgpack")
+  {
+    if (aggregate_claims || histogram_seconds > 0 || unique_tokens)
+    {
+      throw UsageError("--format " + format + " cannot be combined with --aggregate, --histogram or --uniq");
+    }
+    if (isatty(STDOUT_FILENO))
+    {
+      throw UsageError("--format " + format + " writes binary data; redirect or pipe it");
+    }
+
+    write_binary = true;
+    binary_format = format == "cbor" ? jwt::BinaryFormat::Cbor : jwt::BinaryFormat::MessagePack;
+
+    // Frames follow one another directly.
+    pipeline_options.separate_tokens = false;
+  }
+  else if (format == "claims")
+  {
+    if (follow_input || aggregate_claims || histogram_seconds > 0 || unique_tokens)
+    {
+      throw UsageError("--format claims cannot be combined with --follow, --aggregate, --histogram or --uniq");
+    }
+    if (isatty(STDOUT_FILENO))
+    {
+      throw UsageError("--format claims writes binary data; redirect it to a file");
+    }
+    write_claims = true;
+  }
+  else if (format != "pretty")
+  {
+    throw UsageError("--format must be pretty, tsv, csv, cbor, msgpack or claims");
+  }
+
+  if (mode & modeServe)
+  {
+    return;
+  }
+
+  if (mode & modeExtract)
+  {
+    // In extract mode, the trailing arguments name files to scan, and stdin
+    // is streamed rather than read up front.
+    input_paths = std::move(positional);
+    if (follow_input && input_paths.size() != 1)
+    {
+      throw UsageError("--follow requires exactly one file");
+    }
+    return;
+  }
+
+  if (positional.size() > 1)
+  {
+    throw InvalidOptionError(positional.front().c_str());
+  }
+  if (!positional.empty())
+  {
+    input = std::move(positional.front());
   }
 
   if (input.empty() && !isatty(STDIN_FILENO))
   {
+    jwt::ScopedPhase phase{jwt::Phase::Read};
+
     std::stringstream ss;
     std::string line;
     while (std::getline(std::cin, line))
@@ -150,78 +675,411 @@ Program::Program(int argc, char** argv)
     }
 
     input = ss.str();
+    phase.add_bytes(input.size());
   }
 
   if (input.empty())
   {
     throw UsageError("No token detected");
   }
+}
+
+void Program::print_token(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const
+{
+  if (row_formatter)
+  {
+    row_formatter->write_row(os, token);
+    return;
+  }
 
-  use_ansi_colors = isatty(STDOUT_FILENO);
+  if (write_binary)
+  {
+    decoder.print_binary(os, token, binary_format);
+    return;
+  }
+
+  if (!(mode & (modeHeader | modePayload)))
+  {
+    print_everything(os, decoder, token);
+    return;
+  }
+
+  if (mode & modeHeader)
+  {
+    print_header(os, decoder, token);
+  }
+
+  if (mode & modePayload)
+  {
+    if (mode & modeHeader)
+    {
+      os << '\n';
+    }
+    print_payload(os, decoder, token);
+  }
 }
 
-void Program::print_header(const jwt::Jwt& token) const
+void Program::print_header(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const
 {
-  jwt::pretty_print_json(std::cout, token.header(), use_ansi_colors);
+  decoder.print(os, token.header(), use_ansi_colors);
 }
 
-void Program::print_payload(const jwt::Jwt& token) const
+void Program::print_payload(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const
 {
-  jwt::pretty_print_json(std::cout, token.payload(), use_ansi_colors);
+  decoder.print(os, token.payload(), use_ansi_colors);
 }
 
-void Program::print_everything(const jwt::Jwt& token) const
+void Program::print_everything(std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) const
 {
-  std::cout << "Header: " << std::endl;
-  print_header(token);
-  std::cout << std::endl;
+  os << "Header: " << '\n';
+  print_header(os, decoder, token);
+  os << '\n';
+
+  if (!token.ciphertext().empty())
+  {
+    os << "Encrypted Key: " << '\n' << token.encrypted_key() << '\n';
+    os << "Initialization Vector: " << '\n' << token.initialization_vector() << '\n';
+    os << "Ciphertext: " << '\n' << token.ciphertext() << '\n';
+    os << "Authentication Tag: " << '\n' << token.authentication_tag() << '\n';
+    return;
+  }
 
-  std::cout << "Payload: " << std::endl;
-  print_payload(token);
-  std::cout << std::endl;
+  os << "Payload: " << '\n';
+  print_payload(os, decoder, token);
+  os << '\n';
 
-  std::cout << "Signature: " << std::endl;
-  std::cout << token.signature();
-  std::cout << std::endl;
+  os << "Signature: " << '\n';
+  os << token.signature();
+  os << '\n';
 }
 
-void Program::print_raw_json() const
+void Program::print_raw_json()
 {
   jwt::ordered_json j;
   j = input;
 
-  jwt::pretty_print_json(std::cout, j, use_ansi_colors);
+  decoder.print(std::cout, j, use_ansi_colors);
 }
 
-void Program::run()
+void Program::extract_tokens()
 {
-  if (mode & modeRawJson)
+  if (aggregate_claims)
   {
-    print_raw_json();
+    summarize<jwt::ClaimSummary>([] { return std::make_unique<jwt::ClaimSummary>(); });
     return;
   }
 
-  auto token = jwt::Jwt::parse(input);
+  if (histogram_seconds > 0)
+  {
+    auto seconds = histogram_seconds;
+    summarize<jwt::TimeHistogram>([seconds] { return std::make_unique<jwt::TimeHistogram>(seconds); });
+    return;
+  }
 
-  if (mode == modeDefault)
+  if (write_claims)
   {
-    print_everything(token);
+    write_claim_table();
     return;
   }
 
-  if (mode & modeHeader)
+  auto print = [this](std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) {
+    print_token(os, decoder, token);
+  };
+
+  if (unique_tokens)
   {
-    print_header(token);
+    print_distinct_tokens(print);
+    return;
   }
 
-  if (mode & modePayload)
+  if (row_formatter)
   {
-    if (mode & modeHeader)
+    row_formatter->write_header(std::cout);
+  }
+  scan_inputs(print);
+}
+
+void Program::print_distinct_tokens(const TokenPrinter& print)
+{
+  // Only tokens are scanned at first, so that each distinct one is decoded
+  // just once.
+  jwt::DistinctTokens distinct;
+  std::vector<std::string> files;
+  bool labelled = false;
+
+  if (input_paths.empty())
+  {
+    auto source = open_input("", pipeline_options.use_io_uring);
+    scan_source(*source, [&distinct](std::string_view text, std::uint64_t offset, std::uint64_t line) {
+      distinct.add(text, {0, offset, line});
+    });
+  }
+  else
+  {
+    // As with -x, only tokens from several files are labelled.
+    files = expand_inputs(input_paths);
+    if (files.empty())
     {
-      std::cout << std::endl;
+      return;
     }
-    print_payload(token);
+    labelled = files.size() > 1 || files.front() != input_paths.front();
+    scan_files(files, pipeline_options, [&distinct](std::size_t source, std::string_view text, std::uint64_t offset, std::uint64_t line) {
+      distinct.add(text, {static_cast<std::uint32_t>(source), offset, line});
+    });
   }
+
+  auto entries = distinct.entries();
+
+  std::vector<NotedToken> tokens;
+  tokens.reserve(entries.size());
+  for (const auto& entry : entries)
+  {
+    NotedToken token;
+    token.text = entry.text;
+
+    if (labelled)
+    {
+      // A file split across threads has no line numbers.
+      const auto& first = entry.first;
+      token.where = files[first.source]
+          + (first.line != 0 ? ':' + std::to_string(first.line) : "@offset " + std::to_string(first.offset));
+      token.note = token.where + '\n';
+    }
+    else
+    {
+      token.where = "offset " + std::to_string(entry.first.offset);
+    }
+    token.note += "Count: " + std::to_string(entry.count);
+
+    if (entry.count > 1)
+    {
+      token.where += " and " + std::to_string(entry.count - 1) + " more";
+    }
+    tokens.push_back(std::move(token));
+  }
+
+  run_tokens(tokens, pipeline_options, print);
+}
+
+void Program::write_claim_table()
+{
+  // Each decoding thread fills blocks of its own, which are written out
+  // whole as they fill up.
+  std::mutex output_mutex;
+  auto write = [&output_mutex](std::string_view block) {
+    std::lock_guard<std::mutex> lock{output_mutex};
+    std::cout.write(block.data(), static_cast<std::streamsize>(block.size()));
+  };
+
+  std::cout << jwt::ClaimTableWriter::file_header();
+
+  PerThread<jwt::ClaimTableWriter> writers{[&write] { return std::make_unique<jwt::ClaimTableWriter>(write); }};
+  scan_inputs([&writers](std::ostream&, jwt::Decoder&, const jwt::Jwt& token) {
+    writers.local().add(token);
+  });
+  writers.for_each([](jwt::ClaimTableWriter& writer) { writer.finish(); });
+}
+
+void Program::query_claim_table()
+{
+  MappedFile file{query_path};
+  jwt::ClaimTable table{file.data()};
+
+  std::vector<std::string> scratch(query_columns.size());
+  std::vector<std::string_view> fields(query_columns.size());
+
+  row_formatter->write_header(std::cout);
+  table.query(query_conditions, [&](const jwt::ClaimTable::Row& row) {
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+      fields[i] = row.text(query_columns[i], scratch[i]);
+    }
+    row_formatter->write_row(std::cout, fields);
+  });
+}
+
+void Program::query_index()
+{
+  MappedFile file{index_path};
+  jwt::ClaimIndex index{file.data()};
+
+  std::vector<jwt::IndexEntry> entries;
+  index.query(query_conditions, [&entries](const jwt::IndexEntry& entry) { entries.push_back(entry); });
+
+  if (row_formatter)
+  {
+    row_formatter->write_header(std::cout);
+    for (const auto& entry : entries)
+    {
+      auto exp = entry.exp != jwt::kNoExpiry ? std::to_string(entry.exp) : std::string{};
+      auto line = entry.line != 0 ? std::to_string(entry.line) : std::string{};
+      auto offset = std::to_string(entry.offset);
+      row_formatter->write_row(std::cout, {index.string(entry.iss), index.string(entry.sub), exp, index.source(entry.source), line, offset});
+    }
+    return;
+  }
+
+  // Tokens are labelled as with -x over several files, in index order.
+  IndexedTokens texts{index, entries, pipeline_options.use_io_uring};
+  std::vector<NotedToken> tokens;
+  tokens.reserve(entries.size());
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    const auto& entry = entries[i];
+    NotedToken token;
+    token.text = texts.text(i);
+    token.where = std::string{index.source(entry.source)};
+    token.where += entry.line != 0 ? ':' + std::to_string(entry.line) : "@offset " + std::to_string(entry.offset);
+
+    if (token.text.empty())
+    {
+      std::cerr << "Skipping token at " << token.where << ": the file has changed since it was indexed" << std::endl;
+      continue;
+    }
+    token.note = token.where;
+    tokens.push_back(std::move(token));
+  }
+
+  auto print = [this](std::ostream& os, jwt::Decoder& decoder, const jwt::Jwt& token) {
+    print_token(os, decoder, token);
+  };
+  run_tokens(tokens, pipeline_options, print);
+}
+
+template <typename Summary>
+void Program::summarize(const typename PerThread<Summary>::Factory& make)
+{
+  // Each decoding thread folds tokens into its own summary, and the
+  // summaries are merged once all input is done.
+  PerThread<Summary> summaries{make};
+  scan_inputs([&summaries](std::ostream&, jwt::Decoder&, const jwt::Jwt& token) {
+    summaries.local().add(token);
+  });
+
+  auto total = make();
+  summaries.for_each([&total](const Summary& summary) { total->merge(summary); });
+
+  decoder.print(std::cout, total->to_json(), use_ansi_colors);
+  std::cout << '\n';
+}
+
+void Program::scan_inputs(const TokenPrinter& print)
+{
+  if (follow_input)
+  {
+    follow(input_paths.front(), state_path, pipeline_options, print);
+    return;
+  }
+
+  if (input_paths.empty())
+  {
+    auto source = open_input("", pipeline_options.use_io_uring);
+    run_pipeline(*source, pipeline_options, print);
+    return;
+  }
+
+  auto files = expand_inputs(input_paths);
+  if (files.size() == 1 && files.front() == input_paths.front())
+  {
+    // A single plain file reads just like stdin, without labels, but a big
+    // one is worth splitting across threads.
+    std::error_code ec;
+    auto size = std::filesystem::file_size(files.front(), ec);
+    if (!ec && run_split_file(files.front(), size, pipeline_options, print))
+    {
+      return;
+    }
+
+    auto source = open_input(files.front(), pipeline_options.use_io_uring);
+    run_pipeline(*source, pipeline_options, print);
+    return;
+  }
+
+  run_files(files, pipeline_options, print);
+}
+
+void Program::flush_output()
+{
+  {
+    jwt::ScopedPhase phase{jwt::Phase::Flush};
+    std::cout.flush();
+  }
+
+  if (trace)
+  {
+    std::ofstream out{trace_path, std::ios::binary};
+    trace->write(out);
+    if (!out)
+    {
+      throw std::runtime_error("Could not write trace to " + trace_path);
+    }
+  }
+
+  if (stats)
+  {
+    auto wall_time = std::chrono::steady_clock::now() - start_time;
+    stats->print_summary(std::cerr, std::chrono::duration_cast<std::chrono::nanoseconds>(wall_time));
+  }
+}
+
+void Program::run()
+{
+  if (write_claims || write_binary)
+  {
+    set_binary_stdout();
+  }
+
+  if (mode & modeServe)
+  {
+    serve(socket_path);
+  }
+  else if (mode & modeQuery)
+  {
+    query_claim_table();
+  }
+  else if (mode & modeIndex)
+  {
+    if (index_action == "build")
+    {
+      build_index(index_path, expand_inputs(input_paths), pipeline_options);
+    }
+    else
+    {
+      query_index();
+    }
+  }
+  else if (mode & modeRawJson)
+  {
+    print_raw_json();
+  }
+  else if (mode & modeExtract)
+  {
+    extract_tokens();
+  }
+  else
+  {
+    jwt::Jwt token;
+    decoder.parse_into(input, token);
+    if (write_claims)
+    {
+      jwt::ClaimTableWriter writer{[](std::string_view block) {
+        std::cout.write(block.data(), static_cast<std::streamsize>(block.size()));
+      }};
+      std::cout << jwt::ClaimTableWriter::file_header();
+      writer.add(token);
+      writer.finish();
+    }
+    else
+    {
+      if (row_formatter)
+      {
+        row_formatter->write_header(std::cout);
+      }
+      print_token(std::cout, decoder, token);
+    }
+  }
+
+  flush_output();
 }
 
 int main(int argc, char** argv)
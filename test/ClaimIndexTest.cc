@@ -0,0 +1,116 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/ClaimIndex.h"
+#include "libjwt/InputError.h"
+#include "libjwt/Jwt.h"
+
+#include "TestTokens.h"
+
+namespace jwt {
+
+namespace {
+
+// Offsets of the entries matching `where`, in index order.
+std::vector<std::uint64_t> find(const ClaimIndex& index, const std::vector<std::string>& where)
+{
+    std::vector<ClaimCondition> conditions;
+    for (const auto& text : where)
+    {
+        conditions.push_back(ClaimCondition::parse(text));
+    }
+
+    std::vector<std::uint64_t> offsets;
+    index.query(conditions, [&offsets](const IndexEntry& entry) { offsets.push_back(entry.offset); });
+    return offsets;
+}
+
+// Tokens from two threads' builders: offset i has iss "a" or "b", sub
+// "s<i % 5>" and exp 1000 + i, except offset 100, which has neither.  The
+// first keeps its entries in memory, the second spills runs of 7.
+std::string build_index()
+{
+    ClaimIndexBuilder first;
+    ClaimIndexBuilder second{::testing::TempDir() + "claim_index_test.run", 7};
+    for (std::uint64_t i = 0; i < 100; ++i)
+    {
+        auto& builder = i % 3 == 0 ? second : first;
+        builder.add(make_token({{"iss", i < 50 ? "b" : "a"}, {"sub", "s" + std::to_string(i % 5)}, {"exp", 1000 + i}}), static_cast<std::uint32_t>(i % 2), i, i + 1, 10);
+    }
+    second.add(make_token({{"name", "x"}}), 0, 100, 0, 10);
+
+    EXPECT_EQ(101u, first.size() + second.size());
+
+    std::ostringstream out;
+    ClaimIndexBuilder::write(out, {&first, &second}, {"one.log", "two.log"});
+    return out.str();
+}
+
+}
+
+TEST(ClaimIndexTest, looks_up_points_and_ranges)
+{
+    auto file = build_index();
+    ClaimIndex index{file};
+    ASSERT_EQ(101u, index.size());
+    EXPECT_EQ("two.log", index.source(1));
+
+    using Offsets = std::vector<std::uint64_t>;
+    EXPECT_EQ(Offsets({51, 56, 61}), find(index, {"iss=a", "sub=s1", "exp<1066"}));
+    EXPECT_EQ(Offsets({0}), find(index, {"exp=1000"}));
+    EXPECT_EQ(50u, find(index, {"iss=b"}).size());
+    EXPECT_TRUE(find(index, {"iss=zzz"}).empty());
+    EXPECT_TRUE(find(index, {"iss=a", "iss=b"}).empty());
+    EXPECT_TRUE(find(index, {"exp>1010", "exp<1005"}).empty());
+
+    // Entries without the claims sort first.
+    auto all = find(index, {});
+    ASSERT_EQ(101u, all.size());
+    EXPECT_EQ(100u, all.front());
+}
+
+TEST(ClaimIndexTest, searches_subjects_across_issuers)
+{
+    auto file = build_index();
+    ClaimIndex index{file};
+
+    using Offsets = std::vector<std::uint64_t>;
+    EXPECT_EQ(20u, find(index, {"sub=s2"}).size());
+    EXPECT_EQ(Offsets({2, 7, 12}), find(index, {"sub=s2", "exp<=1012"}));
+    EXPECT_EQ(Offsets({92, 97}), find(index, {"sub=s2", "exp>1090"}));
+    EXPECT_EQ(Offsets({50, 51, 48, 49}), find(index, {"exp>=1048", "exp<1052"}));
+}
+
+TEST(ClaimIndexTest, rejects_other_conditions_and_damaged_files)
+{
+    auto file = build_index();
+    ClaimIndex index{file};
+
+    EXPECT_THROW(find(index, {"sub!=s1"}), InputError);
+    EXPECT_THROW(find(index, {"kid=k"}), InputError);
+
+    EXPECT_THROW(ClaimIndex{"not an index"}, InputError);
+    EXPECT_THROW(ClaimIndex{std::string_view{file}.substr(0, file.size() - 8)}, InputError);
+}
+
+}
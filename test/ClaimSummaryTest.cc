@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/ClaimSummary.h"
+#include "libjwt/Jwt.h"
+
+#include "TestTokens.h"
+
+namespace jwt {
+
+TEST(ClaimSummaryTest, counts_claims_across_merges)
+{
+    ClaimSummary first;
+    first.add(make_token({{"alg", "RS256"}, {"kid", "k1"}},
+                         {{"iss", "a"}, {"sub", "alice"}, {"aud", {"api", "web"}}, {"iat", 1000}, {"exp", 4600}}));
+    first.add(make_token({{"alg", "RS256"}, {"kid", "k2"}},
+                         {{"iss", "a"}, {"sub", "bob"}, {"aud", "api"}, {"iat", 1000}, {"exp", 1000}}));
+
+    ClaimSummary second;
+    second.add(make_token({{"alg", "HS256"}},
+                          {{"iss", "b"}, {"sub", "alice"}, {"jti", "x"}, {"iat", 2000}, {"exp", 1000}}));
+    second.add(make_token({{"alg", "none"}}, {{"sub", 42}}));
+
+    first.merge(second);
+    auto json = first.to_json();
+
+    EXPECT_EQ(4u, json["tokens"]);
+    EXPECT_EQ(2u, json["alg"]["RS256"]);
+    EXPECT_EQ("RS256", json["alg"].begin().key());
+    EXPECT_EQ(1u, json["kid"]["k2"]);
+    EXPECT_EQ(2u, json["iss"]["a"]);
+    EXPECT_EQ(1u, json["iss"]["b"]);
+
+    EXPECT_EQ(3u, json["distinct"]["sub"]);
+    EXPECT_EQ(1u, json["distinct"]["jti"]);
+
+    EXPECT_EQ("alice", json["top"]["sub"][0]["value"]);
+    EXPECT_EQ(2u, json["top"]["sub"][0]["count"]);
+    EXPECT_EQ("api", json["top"]["aud"][0]["value"]);
+    EXPECT_EQ(2u, json["top"]["aud"][0]["count"]);
+
+    auto& lifetime = json["lifetime"];
+    ASSERT_EQ(2u, lifetime["seconds"].size());
+    EXPECT_EQ(0u, lifetime["seconds"][0]["max"]);
+    EXPECT_EQ(2048u, lifetime["seconds"][1]["min"]);
+    EXPECT_EQ(4095u, lifetime["seconds"][1]["max"]);
+    EXPECT_EQ(1u, lifetime["negative"]);
+    EXPECT_EQ(1u, lifetime["missing"]);
+}
+
+TEST(ClaimSummaryTest, measures_lifetimes_between_extreme_times)
+{
+    ClaimSummary summary;
+    summary.add(make_token({{"alg", "none"}}, {{"iat", -1000000000000000}, {"exp", 1000000000000000}}));
+    summary.add(make_token({{"alg", "none"}},
+                           {{"iat", std::numeric_limits<std::int64_t>::min()}, {"exp", std::numeric_limits<std::int64_t>::max()}}));
+    auto json = summary.to_json();
+
+    auto& lifetime = json["lifetime"];
+    ASSERT_EQ(1u, lifetime["seconds"].size());
+    EXPECT_LE(2000000000000000u, lifetime["seconds"][0]["max"]);
+    EXPECT_EQ(1u, lifetime["missing"]);
+}
+
+}
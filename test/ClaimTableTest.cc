@@ -0,0 +1,148 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/ClaimTable.h"
+#include "libjwt/InputError.h"
+#include "libjwt/Jwt.h"
+
+#include "TestTokens.h"
+
+namespace jwt {
+
+namespace {
+
+std::string write_table(const std::vector<Jwt>& tokens, std::size_t block_rows)
+{
+    std::string file{ClaimTableWriter::file_header()};
+    ClaimTableWriter writer{[&file](std::string_view block) { file += block; }, block_rows};
+    for (const auto& token : tokens)
+    {
+        writer.add(token);
+    }
+    writer.finish();
+    return file;
+}
+
+std::vector<std::string> select(const ClaimTable& table, const std::vector<std::string>& where, ClaimColumn column)
+{
+    std::vector<ClaimCondition> conditions;
+    for (const auto& text : where)
+    {
+        conditions.push_back(ClaimCondition::parse(text));
+    }
+
+    std::vector<std::string> values;
+    std::string scratch;
+    table.query(conditions, [&](const ClaimTable::Row& row) {
+        values.emplace_back(row.text(column, scratch));
+    });
+    return values;
+}
+
+}
+
+TEST(ClaimTableTest, round_trips_columns_and_leftovers)
+{
+    auto file = write_table({
+        make_token({{"alg", "RS256"}, {"kid", "k1"}, {"x5t", "abc"}},
+                   {{"iss", "a"}, {"sub", "1"}, {"aud", {"x", "y"}}, {"exp", 1792317600}, {"iat", 1.5}, {"role", "admin"}}),
+        make_token({{"alg", "none"}}, {{"sub", 2}}),
+    }, 16);
+
+    ClaimTable table{file};
+    ASSERT_EQ(2u, table.rows());
+
+    std::vector<ClaimTable::Row> rows;
+    table.query({}, [&rows](const ClaimTable::Row& row) { rows.push_back(row); });
+    ASSERT_EQ(2u, rows.size());
+
+    std::string scratch;
+    EXPECT_EQ("RS256", rows[0].text(ClaimColumn::Alg, scratch));
+    EXPECT_EQ("k1", rows[0].text(ClaimColumn::Kid, scratch));
+    EXPECT_FALSE(rows[0].has(ClaimColumn::Typ));
+    EXPECT_EQ("a", rows[0].text(ClaimColumn::Iss, scratch));
+    EXPECT_FALSE(rows[0].has(ClaimColumn::Aud));
+    EXPECT_EQ(1792317600, rows[0].number(ClaimColumn::Exp));
+    EXPECT_EQ("1792317600", rows[0].text(ClaimColumn::Exp, scratch));
+    EXPECT_FALSE(rows[0].has(ClaimColumn::Iat));
+    EXPECT_EQ(R"({"x5t":"abc"})", rows[0].text(ClaimColumn::OtherHeader, scratch));
+    EXPECT_EQ(R"({"aud":["x","y"],"iat":1.5,"role":"admin"})", rows[0].text(ClaimColumn::OtherClaims, scratch));
+
+    EXPECT_FALSE(rows[1].has(ClaimColumn::Sub));
+    EXPECT_EQ("{}", rows[1].text(ClaimColumn::OtherHeader, scratch));
+    EXPECT_EQ(R"({"sub":2})", rows[1].text(ClaimColumn::OtherClaims, scratch));
+}
+
+TEST(ClaimTableTest, filters_across_blocks)
+{
+    std::vector<Jwt> tokens;
+    for (int i = 0; i < 100; ++i)
+    {
+        tokens.push_back(make_token({{"alg", "HS256"}},
+                                    {{"iss", i % 2 == 0 ? "even" : "odd"}, {"sub", std::to_string(i)}, {"exp", 1000 + i}}));
+    }
+    tokens.push_back(make_token({{"alg", "HS256"}}, {{"sub", "none"}}));
+
+    ClaimTable table{write_table(tokens, 8)};
+    EXPECT_EQ(101u, table.rows());
+
+    EXPECT_EQ(std::vector<std::string>({"7"}), select(table, {"sub=7"}, ClaimColumn::Sub));
+    EXPECT_TRUE(select(table, {"sub=missing"}, ClaimColumn::Sub).empty());
+    EXPECT_EQ(50u, select(table, {"iss!=even"}, ClaimColumn::Sub).size());
+    EXPECT_EQ(std::vector<std::string>({"1095", "1097", "1099"}), select(table, {"iss=odd", "exp>=1095"}, ClaimColumn::Exp));
+    EXPECT_EQ(std::vector<std::string>({"0", "1"}), select(table, {"exp<1002"}, ClaimColumn::Sub));
+    EXPECT_EQ(100u, select(table, {"exp!=1"}, ClaimColumn::Sub).size());
+}
+
+TEST(ClaimTableTest, parses_conditions)
+{
+    auto condition = ClaimCondition::parse("exp<=12");
+    EXPECT_EQ(ClaimColumn::Exp, condition.column);
+    EXPECT_EQ(ClaimCondition::Op::LessEqual, condition.op);
+    EXPECT_EQ(12, condition.number);
+
+    condition = ClaimCondition::parse("iss=https://a/?b=c");
+    EXPECT_EQ(ClaimCondition::Op::Equal, condition.op);
+    EXPECT_EQ("https://a/?b=c", condition.text);
+
+    EXPECT_THROW(ClaimCondition::parse("iss"), InputError);
+    EXPECT_THROW(ClaimCondition::parse("name=x"), InputError);
+    EXPECT_THROW(ClaimCondition::parse("iss<x"), InputError);
+    EXPECT_THROW(ClaimCondition::parse("exp>soon"), InputError);
+    EXPECT_THROW(ClaimCondition::parse("other_claims=x"), InputError);
+}
+
+TEST(ClaimTableTest, rejects_damaged_files)
+{
+    auto file = write_table({make_token({{"alg", "none"}}, {{"sub", "1"}})}, 16);
+
+    EXPECT_THROW(ClaimTable{"not a table"}, InputError);
+    EXPECT_THROW(ClaimTable{std::string_view{file}.substr(0, file.size() - 8)}, InputError);
+
+    auto damaged = file;
+    damaged[damaged.size() - 16] = 'x';
+    EXPECT_THROW(ClaimTable{damaged}, InputError);
+
+    EXPECT_NO_THROW(ClaimTable{ClaimTableWriter::file_header()});
+}
+
+}
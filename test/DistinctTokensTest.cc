@@ -0,0 +1,81 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/DistinctTokens.h"
+
+namespace jwt {
+
+TEST(DistinctTokensTest, counts_and_keeps_first_position)
+{
+    DistinctTokens distinct{2};
+    distinct.add("b", {0, 10, 2});
+    distinct.add("a", {0, 20, 3});
+    distinct.add("b", {0, 5, 1});
+    distinct.add("c", {1, 0, 1});
+
+    auto entries = distinct.entries();
+    ASSERT_EQ(3u, entries.size());
+
+    EXPECT_EQ("b", entries[0].text);
+    EXPECT_EQ(2u, entries[0].count);
+    EXPECT_EQ(5u, entries[0].first.offset);
+    EXPECT_EQ(1u, entries[0].first.line);
+
+    EXPECT_EQ("a", entries[1].text);
+    EXPECT_EQ(1u, entries[1].count);
+
+    EXPECT_EQ("c", entries[2].text);
+    EXPECT_EQ(1u, entries[2].first.source);
+}
+
+TEST(DistinctTokensTest, threads_add_concurrently)
+{
+    DistinctTokens distinct;
+
+    // Every thread adds the same 10000 tokens, each at its own offsets.
+    std::vector<std::thread> threads;
+    for (std::uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&distinct, t] {
+            for (std::uint64_t i = 0; i < 10000; ++i)
+            {
+                distinct.add("token " + std::to_string(i), {0, i * 4 + t, 0});
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto entries = distinct.entries();
+    ASSERT_EQ(10000u, entries.size());
+    for (std::uint64_t i = 0; i < entries.size(); ++i)
+    {
+        EXPECT_EQ("token " + std::to_string(i), entries[i].text);
+        EXPECT_EQ(4u, entries[i].count);
+        EXPECT_EQ(i * 4, entries[i].first.offset);
+    }
+}
+
+}
@@ -0,0 +1,59 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/Jwt.h"
+#include "libjwt/RowFormatter.h"
+
+namespace jwt {
+
+namespace {
+
+const Jwt kToken{"", "", "", {{"alg", "RS256"}, {"kid", "k1"}, {"sub", "header sub"}},
+                 {{"iss", "https://issuer.example.com"}, {"sub", "tab\there, \"quoted\""},
+                  {"exp", 1792317600}, {"admin", true}, {"aud", {"a", "b"}}}};
+
+std::string format(RowFormatter::Format format, const std::vector<std::string>& columns)
+{
+    RowFormatter formatter{format, columns};
+    std::ostringstream os;
+    formatter.write_header(os);
+    formatter.write_row(os, kToken);
+    return os.str();
+}
+
+}
+
+TEST(RowFormatterTest, writes_tsv)
+{
+    EXPECT_EQ("iss\tsub\texp\tkid\tmissing\n"
+              "https://issuer.example.com\ttab\\there, \"quoted\"\t1792317600\tk1\t\n",
+              format(RowFormatter::Format::Tsv, {"iss", "sub", "exp", "kid", "missing"}));
+}
+
+TEST(RowFormatterTest, writes_csv)
+{
+    EXPECT_EQ("header.sub,payload.sub,admin,aud\n"
+              "header sub,\"tab\there, \"\"quoted\"\"\",true,\"[\"\"a\"\",\"\"b\"\"]\"\n",
+              format(RowFormatter::Format::Csv, {"header.sub", "payload.sub", "admin", "aud"}));
+}
+
+}
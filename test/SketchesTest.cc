@@ -0,0 +1,107 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/Hash.h"
+#include "libjwt/Sketches.h"
+
+namespace jwt {
+
+TEST(SketchesTest, murmur3_matches_reference)
+{
+    EXPECT_EQ((Hash128{0, 0}), murmur3_128(""));
+    EXPECT_EQ((Hash128{0xcbd8a7b341bd9b02ULL, 0x5b1e906a48ae1d19ULL}), murmur3_128("hello"));
+    EXPECT_EQ((Hash128{0xe34bbc7bbc071b6cULL, 0x7a433ca9c49a9347ULL}),
+              murmur3_128("The quick brown fox jumps over the lazy dog"));
+}
+
+TEST(SketchesTest, hyperloglog_estimates_and_merges)
+{
+    HyperLogLog first;
+    HyperLogLog second;
+    for (int i = 0; i < 100000; ++i)
+    {
+        auto hash = murmur3_128(std::to_string(i)).low;
+        (i % 2 == 0 ? first : second).add(hash);
+
+        // Repeats must not count.
+        first.add(hash);
+    }
+
+    EXPECT_EQ(0.0, HyperLogLog{}.estimate());
+    EXPECT_NEAR(100000, first.estimate(), 4000);
+
+    first.merge(second);
+    EXPECT_NEAR(100000, first.estimate(), 4000);
+}
+
+TEST(SketchesTest, top_k_keeps_heavy_hitters)
+{
+    TopK first{20};
+    TopK second{20};
+    for (int i = 0; i < 10000; ++i)
+    {
+        auto& top = i % 2 == 0 ? first : second;
+        top.add(std::to_string(i));
+        if (i % 10 == 0)
+        {
+            top.add("common", 3);
+        }
+        if (i % 20 == 0)
+        {
+            top.add("less common", 2);
+        }
+    }
+
+    first.merge(second);
+    auto top = first.top(2);
+    ASSERT_EQ(2u, top.size());
+
+    EXPECT_EQ("common", top[0].value);
+    EXPECT_LE(3000u, top[0].count);
+    EXPECT_GE(3000u, top[0].count - top[0].error);
+
+    EXPECT_EQ("less common", top[1].value);
+    EXPECT_LE(1000u, top[1].count);
+    EXPECT_GE(1000u, top[1].count - top[1].error);
+}
+
+TEST(SketchesTest, log2_histogram_buckets)
+{
+    Log2Histogram histogram;
+    histogram.add(0);
+    histogram.add(1);
+    histogram.add(3600);
+    histogram.add(4095);
+
+    Log2Histogram other;
+    other.add(2048);
+    histogram.merge(other);
+
+    EXPECT_EQ(1u, histogram.count(0));
+    EXPECT_EQ(1u, histogram.count(1));
+    EXPECT_EQ(3u, histogram.count(12));
+    EXPECT_EQ(2048u, Log2Histogram::lower_bound(12));
+    EXPECT_EQ(4096u, Log2Histogram::lower_bound(13));
+}
+
+}
@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/Decoder.h"
+#include "libjwt/Stats.h"
+
+namespace jwt {
+
+TEST(StatsTest, decoder_reports_phases_and_errors)
+{
+    Stats stats;
+    set_stats(&stats);
+
+    Decoder decoder;
+    Jwt token;
+    JwtError error;
+    EXPECT_TRUE(decoder.try_parse_into("eyJhbGciOiJub25lIn0.eyJzdWIiOiIxIn0.", token, error));
+    EXPECT_FALSE(decoder.try_parse_into("eyJhbGciOiJub25lIn0.e30.x.y", token, error));
+
+    set_stats(nullptr);
+
+    EXPECT_EQ(1u, stats.tokens());
+    EXPECT_EQ(1u, stats.errors(JwtError::Code::SegmentCount));
+    EXPECT_EQ(2u, stats.totals(Phase::Split).count);
+    EXPECT_EQ(2u, stats.totals(Phase::Base64Decode).count);
+    EXPECT_EQ(2u, stats.totals(Phase::JsonParse).count);
+    EXPECT_EQ(std::string{"{\"alg\":\"none\"}"}.size() + std::string{"{\"sub\":\"1\"}"}.size(),
+              stats.totals(Phase::JsonParse).bytes);
+}
+
+}
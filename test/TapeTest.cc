@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/JsonPrinter.h"
+#include "libjwt/Tape.h"
+
+namespace jwt {
+
+namespace {
+
+const char* kPayload = R"({"sub":"1234567890","name":"John Doe","iat":1516239022,"neg":-3,"pi":3.5,"admin":true,"none":null,"aud":["a","b",{}],"nested":{"x":[]}})";
+
+}
+
+TEST(TapeTest, prints_like_ordered_json)
+{
+    Tape tape;
+    auto root = tape.parse(kPayload);
+
+    std::stringstream expected;
+    pretty_print_json(expected, ordered_json::parse(kPayload), false);
+
+    std::stringstream actual;
+    pretty_print_json(actual, tape, root, false);
+
+    EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(TapeTest, find)
+{
+    Tape tape;
+    auto root = tape.parse(kPayload);
+
+    auto sub = tape.find(root, "sub");
+    ASSERT_NE(Tape::npos, sub);
+    EXPECT_EQ(Tape::Type::String, tape.type(sub));
+    EXPECT_EQ("1234567890", tape.get_string(sub));
+
+    auto iat = tape.find(root, "iat");
+    ASSERT_NE(Tape::npos, iat);
+    EXPECT_EQ(1516239022u, tape.get_unsigned(iat));
+
+    EXPECT_EQ(-3, tape.get_signed(tape.find(root, "neg")));
+    EXPECT_EQ(3.5, tape.get_double(tape.find(root, "pi")));
+    EXPECT_EQ(Tape::Type::True, tape.type(tape.find(root, "admin")));
+    EXPECT_EQ(Tape::npos, tape.find(root, "exp"));
+
+    auto nested = tape.find(root, "nested");
+    EXPECT_EQ(Tape::Type::ArrayStart, tape.type(tape.find(nested, "x")));
+    EXPECT_EQ(tape.size(), tape.next(root));
+}
+
+TEST(TapeTest, holds_many_documents)
+{
+    Tape tape;
+    auto first = tape.parse(R"({"alg":"HS256"})");
+    auto second = tape.append(ordered_json::parse(R"({"alg":"none","typ":"JWT"})"));
+
+    EXPECT_EQ(second, tape.next(first));
+    EXPECT_EQ("HS256", tape.get_string(tape.find(first, "alg")));
+    EXPECT_EQ("JWT", tape.get_string(tape.find(second, "typ")));
+}
+
+TEST(TapeTest, invalid_json_leaves_tape_unchanged)
+{
+    Tape tape;
+    tape.parse(R"({"alg":"HS256"})");
+    auto size = tape.size();
+
+    EXPECT_THROW(tape.parse(R"({"alg":["HS256")"), ordered_json::parse_error);
+    EXPECT_EQ(size, tape.size());
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef JWT_TEST_TESTTOKENS_H
+#define JWT_TEST_TESTTOKENS_H
+
+#pragma once
+
+#include <utility>
+
+#include "libjwt/Jwt.h"
+
+namespace jwt {
+
+// An unsigned token built straight from its decoded parts, for tests of what
+// is gathered from claims.
+inline Jwt make_token(ordered_json header, ordered_json payload)
+{
+    return Jwt{header.dump(), payload.dump(), "", std::move(header), std::move(payload)};
+}
+
+inline Jwt make_token(ordered_json payload)
+{
+    return make_token({{"alg", "none"}}, std::move(payload));
+}
+
+} // namespace jwt
+
+#endif // JWT_TEST_TESTTOKENS_H
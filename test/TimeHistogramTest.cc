@@ -0,0 +1,90 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/Jwt.h"
+#include "libjwt/TimeHistogram.h"
+
+#include "TestTokens.h"
+
+namespace jwt {
+
+TEST(TimeHistogramTest, formats_utc)
+{
+    EXPECT_EQ("1970-01-01T00:00:00Z", format_utc(0));
+    EXPECT_EQ("1969-12-31T23:59:59Z", format_utc(-1));
+    EXPECT_EQ("2000-02-29T12:34:56Z", format_utc(951827696));
+    EXPECT_EQ("2026-10-18T10:00:00Z", format_utc(1792317600));
+}
+
+TEST(TimeHistogramTest, buckets_by_issuer_across_merges)
+{
+    TimeHistogram first{TimeHistogram::kMinute};
+    first.add(make_token({{"iss", "a"}, {"iat", 1792317600}, {"exp", 1792317659}}));
+    first.add(make_token({{"iss", "b"}, {"iat", 1792317601}}));
+
+    TimeHistogram second{TimeHistogram::kMinute};
+    second.add(make_token({{"iss", "a"}, {"iat", 1792317630.5}, {"exp", 1792317660}}));
+    second.add(make_token({{"exp", 1792317600}}));
+    second.add(make_token({{"sub", "x"}}));
+
+    first.merge(second);
+    auto json = first.to_json();
+
+    EXPECT_EQ(60, json["bucket_seconds"]);
+    EXPECT_EQ(1u, json["untimed"]);
+
+    auto& rows = json["buckets"];
+    ASSERT_EQ(4u, rows.size());
+
+    EXPECT_EQ("2026-10-18T10:00:00Z", rows[0]["time"]);
+    EXPECT_TRUE(rows[0]["iss"].is_null());
+    EXPECT_EQ(0u, rows[0]["issued"]);
+    EXPECT_EQ(1u, rows[0]["expiring"]);
+
+    EXPECT_EQ("a", rows[1]["iss"]);
+    EXPECT_EQ(2u, rows[1]["issued"]);
+    EXPECT_EQ(1u, rows[1]["expiring"]);
+
+    EXPECT_EQ("b", rows[2]["iss"]);
+    EXPECT_EQ(1u, rows[2]["issued"]);
+
+    EXPECT_EQ("2026-10-18T10:01:00Z", rows[3]["time"]);
+    EXPECT_EQ("a", rows[3]["iss"]);
+    EXPECT_EQ(0u, rows[3]["issued"]);
+    EXPECT_EQ(1u, rows[3]["expiring"]);
+}
+
+TEST(TimeHistogramTest, leaves_implausible_times_untimed)
+{
+    TimeHistogram histogram{TimeHistogram::kDay};
+    histogram.add(make_token({{"iat", std::numeric_limits<std::int64_t>::min()}}));
+    histogram.add(make_token({{"exp", std::numeric_limits<std::uint64_t>::max()}}));
+    histogram.add(make_token({{"iat", -1000000000000000}}));
+    auto json = histogram.to_json();
+
+    EXPECT_EQ(2u, json["untimed"]);
+    ASSERT_EQ(1u, json["buckets"].size());
+    EXPECT_EQ(0u, json["buckets"][0]["expiring"]);
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "libjwt/Decoder.h"
+#include "libjwt/Trace.h"
+
+namespace jwt {
+
+TEST(TraceTest, records_spans_per_thread)
+{
+    Trace trace;
+    set_trace(&trace);
+
+    auto decode = [] {
+        Decoder decoder;
+        Jwt token;
+        decoder.parse_into("eyJhbGciOiJub25lIn0.eyJzdWIiOiIxIn0.", token);
+    };
+    decode();
+    std::thread worker{[&] {
+        trace.set_thread_name("worker");
+        decode();
+    }};
+    worker.join();
+
+    set_trace(nullptr);
+
+    std::stringstream ss;
+    trace.write(ss);
+    auto json = ordered_json::parse(ss.str());
+
+    std::set<std::string> names;
+    std::set<int> tids;
+    for (auto& event : json["traceEvents"])
+    {
+        if (event["ph"] == "X")
+        {
+            names.insert(event["name"].get<std::string>());
+            tids.insert(event["tid"].get<int>());
+        }
+        else if (event["ph"] == "M" && event["tid"] == 2)
+        {
+            EXPECT_EQ("worker", event["args"]["name"]);
+        }
+    }
+
+    EXPECT_EQ((std::set<std::string>{"token", "split", "base64", "json"}), names);
+    EXPECT_EQ((std::set<int>{1, 2}), tids);
+}
+
+TEST(TraceTest, keeps_the_latest_spans_when_full)
+{
+    Trace trace{2};
+    auto now = Trace::Clock::now();
+    trace.record("a", now, now);
+    trace.record("b", now, now);
+    trace.record("c", now, now);
+
+    std::stringstream ss;
+    trace.write(ss);
+    auto json = ordered_json::parse(ss.str());
+
+    std::vector<std::string> names;
+    for (auto& event : json["traceEvents"])
+    {
+        names.push_back(event["name"].get<std::string>());
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"thread_name", "dropped_events", "b", "c"}), names);
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+Copyright (C) 2026 Benjamin Bader
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "UringSource.h"
+
+#if defined(JWT_HAVE_IO_URING)
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "InputSource.h"
+
+namespace {
+
+// A file several times the size of the ring, so that reads wrap around and
+// complete out of order.  Dropping it from the page cache makes the kernel
+// hand the reads to its workers instead of completing them inline.
+class UringSourceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::string name = ::testing::TempDir() + "uring_source_test.XXXXXX";
+        int fd = mkstemp(name.data());
+        ASSERT_NE(-1, fd);
+        path_ = name;
+
+        contents_.resize(5 * 1024 * 1024 + 4321);
+        std::uint32_t state = 12345;
+        for (auto& c : contents_)
+        {
+            state = state * 1664525 + 1013904223;
+            c = static_cast<char>(state >> 24);
+        }
+
+        ASSERT_EQ(static_cast<ssize_t>(contents_.size()), write(fd, contents_.data(), contents_.size()));
+        fsync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    void TearDown() override
+    {
+        if (!path_.empty())
+        {
+            std::remove(path_.c_str());
+        }
+    }
+
+    static std::string read_all(InputSource& source, std::size_t chunk)
+    {
+        std::string result;
+        std::string buffer(chunk, '\0');
+        while (auto n = source.read(buffer.data(), buffer.size()))
+        {
+            result.append(buffer.data(), n);
+        }
+        return result;
+    }
+
+    std::string path_;
+    std::string contents_;
+};
+
+}
+
+TEST_F(UringSourceTest, reads_the_same_bytes_as_stdio)
+{
+    auto uring = UringSource::open(path_);
+    if (!uring)
+    {
+        GTEST_SKIP() << "io_uring is not available here";
+    }
+
+    FileSource file{path_};
+    auto expected = read_all(file, 64 * 1024);
+    ASSERT_EQ(contents_, expected);
+
+    auto actual = read_all(*uring, 7919);
+    EXPECT_EQ(expected.size(), actual.size());
+    EXPECT_TRUE(expected == actual);
+}
+
+TEST_F(UringSourceTest, reads_the_same_range_as_stdio)
+{
+    ByteRange range {123457, contents_.size() - 98765};
+    auto uring = UringSource::open(path_, range);
+    if (!uring)
+    {
+        GTEST_SKIP() << "io_uring is not available here";
+    }
+
+    FileSource file{path_, range};
+    auto expected = read_all(file, 64 * 1024);
+    ASSERT_EQ(contents_.substr(range.begin, range.end - range.begin), expected);
+
+    auto actual = read_all(*uring, 1 << 20);
+    EXPECT_EQ(expected.size(), actual.size());
+    EXPECT_TRUE(expected == actual);
+}
+
+TEST_F(UringSourceTest, reuses_its_ring_after_an_abandoned_read)
+{
+    std::string expected = contents_.substr(4096, 600000);
+    for (int i = 0; i < 3; ++i)
+    {
+        // Stop partway, with reads still in flight, before opening the next.
+        auto abandoned = UringSource::open(path_);
+        if (!abandoned)
+        {
+            GTEST_SKIP() << "io_uring is not available here";
+        }
+        char buffer[1000];
+        ASSERT_EQ(sizeof(buffer), abandoned->read(buffer, sizeof(buffer)));
+        abandoned.reset();
+
+        auto uring = UringSource::open(path_, ByteRange{4096, 604096});
+        ASSERT_TRUE(uring);
+        EXPECT_TRUE(expected == read_all(*uring, 4096));
+    }
+}
+
+#endif // JWT_HAVE_IO_URING